@@ -1,32 +1,129 @@
 #ifndef RGU_LABS_TERM4_ARITHMETIC_FFT_HPP
 #define RGU_LABS_TERM4_ARITHMETIC_FFT_HPP
+#include <bit>
+#include <cmath>
 #include <complex>
+#include <limits>
 #include <vector>
 
 using CD = std::complex<double>;
 const double PI = acos(-1.0);
 
-inline void fft(std::vector<CD>& arr, bool inverse) {
+// exp(2 pi i j / n) for j < n / 2, n a power of two. Only the first
+// octant calls cos and sin; the rest follows by exact reflections. The
+// angle 2 pi j / n is off by at most 2.01 * 2^-53 * pi and cos and sin add
+// under an ulp each, so every entry is within 8 * 2^-53 of the exact root,
+// the constant fft_convolution_error_bound relies on.
+inline std::vector<CD> fft_roots(const size_t n) {
+  std::vector<CD> roots(n / 2);
+  const size_t quarter = n / 4;
+  for (size_t j = 0; j <= quarter / 2 && j < roots.size(); ++j) {
+    const double ang = 2 * PI * static_cast<double>(j) / static_cast<double>(n);
+    roots[j] = CD(std::cos(ang), std::sin(ang));
+    if (quarter > 0 && j > 0) { roots[quarter - j] = CD(roots[j].imag(), roots[j].real()); }
+  }
+  for (size_t j = quarter; j < n / 2 && quarter > 0; ++j) {
+    roots[j] = CD(-roots[j - quarter].imag(), roots[j - quarter].real());
+  }
+  return roots;
+}
+
+// fft() with a table from fft_roots(arr.size()); the inverse uses the
+// conjugate roots. The butterflies work on the interleaved doubles of the
+// array, as std::complex allows: copying whole complex values there stalls
+// on store forwarding and runs several times slower.
+inline void fft(std::vector<CD>& arr, const std::vector<CD>& roots,
+                bool inverse) {
   const size_t n = arr.size();
-  if (n == 1) { return; }
+  if (n <= 1) { return; }
+
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) { j ^= bit; }
+    j ^= bit;
+    if (i < j) { std::swap(arr[i], arr[j]); }
+  }
 
-  std::vector<CD> even(n / 2), odd(n / 2);
-  for (size_t i = 0; i < n / 2; ++i) {
-    even[i] = arr[2 * i];
-    odd[i] = arr[2 * i + 1];
+  double* data = reinterpret_cast<double*>(arr.data());
+  const double* w = reinterpret_cast<const double*>(roots.data());
+  const double sign = inverse ? -1.0 : 1.0;
+  for (size_t len = 2; len <= n; len <<= 1) {
+    const size_t stride = n / len;
+    for (size_t start = 0; start < n; start += len) {
+      for (size_t i = 0; i < len / 2; ++i) {
+        const double wr = w[2 * i * stride];
+        const double wi = sign * w[2 * i * stride + 1];
+        double* even = data + 2 * (start + i);
+        double* odd = data + 2 * (start + i + len / 2);
+        const double tr = wr * odd[0] - wi * odd[1];
+        const double ti = wr * odd[1] + wi * odd[0];
+        odd[0] = even[0] - tr;
+        odd[1] = even[1] - ti;
+        even[0] += tr;
+        even[1] += ti;
+      }
+    }
   }
+}
 
-  fft(even, inverse);
-  fft(odd, inverse);
+// Unscaled DFT of a power-of-two length array, with exp(2 pi i / n) as the
+// root of unity (exp(-2 pi i / n) for the inverse). Iterative radix 2.
+inline void fft(std::vector<CD>& arr, bool inverse) {
+  fft(arr, fft_roots(arr.size()), inverse);
+}
 
-  const double ang = 2 * PI / n * (inverse ? -1 : 1);
-  CD w(1);
-  const CD wn(std::cos(ang), std::sin(ang));
-  for (size_t i = 0; i < n / 2; ++i) {
-    arr[i] = even[i] + w * odd[i];
-    arr[i + n / 2] = even[i] - w * odd[i];
-    w *= wn;
+// Linear convolution of two real sequences (the coefficients of a product
+// of polynomials) through fft(), unrounded.
+inline std::vector<double> fft_convolution(const std::vector<double>& a,
+                                           const std::vector<double>& b) {
+  if (a.empty() || b.empty()) { return {}; }
+  const size_t result_size = a.size() + b.size() - 1;
+  const size_t n = std::bit_ceil(result_size);
+
+  std::vector<CD> f(n), g(n);
+  for (size_t i = 0; i < a.size(); ++i) f[i] = a[i];
+  for (size_t i = 0; i < b.size(); ++i) g[i] = b[i];
+  const std::vector<CD> roots = fft_roots(n);
+  fft(f, roots, false);
+  fft(g, roots, false);
+  for (size_t i = 0; i < n; ++i) {
+    f[i] = CD(f[i].real() * g[i].real() - f[i].imag() * g[i].imag(),
+              f[i].real() * g[i].imag() + f[i].imag() * g[i].real());
   }
+  fft(f, roots, true);
+
+  std::vector<double> result(result_size);
+  for (size_t i = 0; i < result_size; ++i)
+    result[i] = f[i].real() / static_cast<double>(n);
+  return result;
+}
+
+// Bound on the error of every entry of fft_convolution(a, b), from
+// Percival's analysis of FFT multiplication (Brent and Zimmermann, Modern
+// Computer Arithmetic, 3.3.2): with m = log2 of the transform length,
+// u = 2^-53 and twiddles within beta of exact,
+//
+//   |error| <= |a|_2 |b|_2 ((1 + u)^3m (1 + sqrt(5) u)^(3m + 1)
+//                           (1 + beta)^3m - 1).
+//
+// The last factor absorbs rounding in the norms and in the bound itself.
+// Overflow and underflow are not covered.
+inline double fft_convolution_error_bound(const std::vector<double>& a,
+                                          const std::vector<double>& b) {
+  if (a.empty() || b.empty()) { return 0.0; }
+  constexpr double u = std::numeric_limits<double>::epsilon() / 2;
+  constexpr double beta = 8 * u;
+  const double m =
+      std::bit_width(std::bit_ceil(a.size() + b.size() - 1)) - 1.0;
+
+  double a_norm2 = 0.0, b_norm2 = 0.0;
+  for (const double x : a) a_norm2 += x * x;
+  for (const double x : b) b_norm2 += x * x;
+
+  const double growth = std::expm1(3 * m * std::log1p(u) +
+                                   (3 * m + 1) * std::log1p(std::sqrt(5.0) * u) +
+                                   3 * m * std::log1p(beta));
+  return std::sqrt(a_norm2 * b_norm2) * growth * (1 + 1e-6);
 }
 
-#endif //RGU_LABS_TERM4_ARITHMETIC_FFT_HPP
\ No newline at end of file
+#endif //RGU_LABS_TERM4_ARITHMETIC_FFT_HPP
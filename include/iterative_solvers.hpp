@@ -0,0 +1,541 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "matrix.hpp"
+#include "sparse_matrix.hpp"
+
+// Iterative solvers for A x = b in double, for systems where elimination is
+// wasteful: large, sparse, diagonally dominant or SPD.
+//
+//   conjugate_gradient  A symmetric positive definite
+//   bicgstab, gmres     any nonsingular A
+//   jacobi, gauss_seidel, sor
+//                       stationary; converge for diagonally dominant (and,
+//                       for Gauss-Seidel and SOR with 0 < omega < 2, SPD) A
+//
+// Krylov methods only need A x, so A is any LinearOperator: Matrix,
+// SparseMatrix, or a type that applies A without storing it. They take a
+// preconditioner M ~ A^-1 (IdentityPreconditioner, JacobiPreconditioner,
+// ILU0Preconditioner or any type with apply()), and stop once
+// ||b - A x|| <= eps ||b||. Stationary methods read A entry by entry and,
+// like simple_iteration, stop once no component moves by eps or more.
+//
+// Every solver starts from x = 0 and returns {solution, iterations,
+// converged} the way simple_iteration and newton_system do; passing `steps`
+// records the quantity tested against eps after every iteration.
+
+struct IterativeResult {
+  std::vector<double> solution;
+  size_t iterations;
+  bool converged;
+};
+
+struct IterativeStep {
+  size_t iteration;
+  double error;
+};
+
+template <typename Operator>
+concept LinearOperator = requires(const Operator& a,
+                                  const std::vector<double>& x) {
+  { a.rows() } -> std::convertible_to<size_t>;
+  { a.multiply(x) } -> std::convertible_to<std::vector<double>>;
+};
+
+template <typename Preconditioner>
+concept PreconditionerFor = requires(const Preconditioner& m,
+                                     const std::vector<double>& r) {
+  { m.apply(r) } -> std::convertible_to<std::vector<double>>;
+};
+
+// Helpers shared by the solvers, kept out of the global namespace; a
+// global norm() would sit next to std::norm.
+namespace iterative_detail {
+
+inline double dot(const std::vector<double>& a, const std::vector<double>& b) {
+  double sum = 0.0;
+  for (size_t i = 0; i < a.size(); ++i) {
+    sum += a[i] * b[i];
+  }
+  return sum;
+}
+
+inline double norm(const std::vector<double>& a) { return std::sqrt(dot(a, a)); }
+
+// y += alpha * x.
+inline void add_scaled(std::vector<double>& y, double alpha,
+                       const std::vector<double>& x) {
+  subtract_scaled(y.data(), x.data(), -alpha, y.size());
+}
+
+// Calls visit(col, value) for every nonzero of row `row`.
+template <typename Visit>
+void for_each_in_row(const Matrix& a, size_t row, Visit&& visit) {
+  const double* values = a.row_data(row);
+  for (size_t col = 0; col < a.cols(); ++col) {
+    if (values[col] != 0.0) {
+      visit(col, values[col]);
+    }
+  }
+}
+
+template <typename Visit>
+void for_each_in_row(const SparseMatrix& a, size_t row, Visit&& visit) {
+  for (size_t k = a.row_start()[row]; k < a.row_start()[row + 1]; ++k) {
+    visit(a.col_index()[k], a.values()[k]);
+  }
+}
+
+template <typename MatrixType>
+std::vector<double> diagonal_of(const MatrixType& a, const std::string& op) {
+  std::vector<double> diagonal(a.rows(), 0.0);
+  for (size_t i = 0; i < a.rows(); ++i) {
+    for_each_in_row(a, i, [&](size_t col, double value) {
+      if (col == i) {
+        diagonal[i] = value;
+      }
+    });
+    if (diagonal[i] == 0.0) {
+      throw std::runtime_error("Zero diagonal entry in operation: " + op);
+    }
+  }
+  return diagonal;
+}
+
+inline void check_system(size_t rows, size_t cols, size_t rhs,
+                         const std::string& op) {
+  if (rows != cols) {
+    throw std::runtime_error("Matrix must be square for operation: " + op);
+  }
+  if (rhs != rows) {
+    throw std::runtime_error("Matrix size mismatch in operation: " + op);
+  }
+}
+
+}  // namespace iterative_detail
+
+struct IdentityPreconditioner {
+  std::vector<double> apply(const std::vector<double>& r) const { return r; }
+};
+
+// M = diag(A)^-1.
+class JacobiPreconditioner {
+ private:
+  std::vector<double> inverse_diagonal_;
+
+ public:
+  explicit JacobiPreconditioner(const Matrix& a)
+      : inverse_diagonal_(
+            iterative_detail::diagonal_of(a, "jacobi_preconditioner")) {
+    invert();
+  }
+  explicit JacobiPreconditioner(const SparseMatrix& a)
+      : inverse_diagonal_(
+            iterative_detail::diagonal_of(a, "jacobi_preconditioner")) {
+    invert();
+  }
+
+  std::vector<double> apply(const std::vector<double>& r) const {
+    std::vector<double> z(r.size());
+    for (size_t i = 0; i < r.size(); ++i) {
+      z[i] = inverse_diagonal_[i] * r[i];
+    }
+    return z;
+  }
+
+ private:
+  void invert() {
+    for (double& value : inverse_diagonal_) {
+      value = 1.0 / value;
+    }
+  }
+};
+
+// Incomplete LU with zero fill: L U restricted to the nonzero pattern of A,
+// computed row by row (IKJ order). A dense Matrix contributes the pattern
+// of its nonzero entries.
+class ILU0Preconditioner {
+ private:
+  size_t n_{};
+  std::vector<size_t> row_start_;
+  std::vector<size_t> col_index_;
+  // Unit L strictly below the diagonal, U on and above it.
+  std::vector<double> values_;
+  std::vector<size_t> diagonal_;
+
+ public:
+  explicit ILU0Preconditioner(const Matrix& a)
+      : ILU0Preconditioner(SparseMatrix(a)) {}
+
+  explicit ILU0Preconditioner(const SparseMatrix& a)
+      : n_(a.rows()),
+        row_start_(a.row_start()),
+        col_index_(a.col_index()),
+        values_(a.values()),
+        diagonal_(a.rows()) {
+    iterative_detail::check_system(a.rows(), a.cols(), a.rows(), "ilu0");
+    constexpr size_t kNone = std::numeric_limits<size_t>::max();
+    for (size_t i = 0; i < n_; ++i) {
+      diagonal_[i] = kNone;
+      for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+        if (col_index_[k] == i) {
+          diagonal_[i] = k;
+        }
+      }
+      if (diagonal_[i] == kNone) {
+        throw std::runtime_error("Zero diagonal entry in operation: ilu0");
+      }
+    }
+
+    std::vector<size_t> position(n_, kNone);
+    for (size_t i = 0; i < n_; ++i) {
+      for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+        position[col_index_[k]] = k;
+      }
+      for (size_t k = row_start_[i]; k < diagonal_[i]; ++k) {
+        const size_t pivot = col_index_[k];
+        const double u_pivot = values_[diagonal_[pivot]];
+        if (u_pivot == 0.0) {
+          throw std::runtime_error("Zero pivot in operation: ilu0");
+        }
+        values_[k] /= u_pivot;
+        for (size_t m = diagonal_[pivot] + 1; m < row_start_[pivot + 1];
+             ++m) {
+          const size_t slot = position[col_index_[m]];
+          if (slot != kNone) {
+            values_[slot] -= values_[k] * values_[m];
+          }
+        }
+      }
+      for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+        position[col_index_[k]] = kNone;
+      }
+      if (values_[diagonal_[i]] == 0.0) {
+        throw std::runtime_error("Zero pivot in operation: ilu0");
+      }
+    }
+  }
+
+  // z = U^-1 L^-1 r.
+  std::vector<double> apply(const std::vector<double>& r) const {
+    std::vector<double> z = r;
+    for (size_t i = 0; i < n_; ++i) {
+      for (size_t k = row_start_[i]; k < diagonal_[i]; ++k) {
+        z[i] -= values_[k] * z[col_index_[k]];
+      }
+    }
+    for (size_t i = n_; i-- > 0;) {
+      for (size_t k = diagonal_[i] + 1; k < row_start_[i + 1]; ++k) {
+        z[i] -= values_[k] * z[col_index_[k]];
+      }
+      z[i] /= values_[diagonal_[i]];
+    }
+    return z;
+  }
+};
+
+// Preconditioned conjugate gradient.
+template <LinearOperator Operator,
+          PreconditionerFor Preconditioner = IdentityPreconditioner>
+IterativeResult conjugate_gradient(
+  const Operator& a,
+  const std::vector<double>& b,
+  const Preconditioner& m = {},
+  double eps = 1e-10,
+  size_t max_iter = 10000,
+  std::vector<IterativeStep>* steps = nullptr
+) {
+  using namespace iterative_detail;
+  check_system(a.rows(), b.size(), b.size(), "conjugate_gradient");
+  const double b_norm = norm(b) == 0.0 ? 1.0 : norm(b);
+  std::vector<double> x(b.size(), 0.0);
+  std::vector<double> r = b;
+  if (norm(r) <= eps * b_norm)
+    return {x, 0, true};
+  std::vector<double> z = m.apply(r);
+  std::vector<double> p = z;
+  double rz = dot(r, z);
+
+  for (size_t i = 0; i < max_iter; ++i) {
+    const std::vector<double> ap = a.multiply(p);
+    const double curvature = dot(p, ap);
+    if (curvature == 0.0)
+      return {x, i, false};
+    const double alpha = rz / curvature;
+    add_scaled(x, alpha, p);
+    add_scaled(r, -alpha, ap);
+
+    const double error = norm(r) / b_norm;
+    if (steps)
+      steps->push_back({i + 1, error});
+    if (error <= eps)
+      return {x, i + 1, true};
+
+    z = m.apply(r);
+    const double rz_new = dot(r, z);
+    const double beta = rz_new / rz;
+    rz = rz_new;
+    for (size_t k = 0; k < p.size(); ++k) {
+      p[k] = z[k] + beta * p[k];
+    }
+  }
+  return {x, max_iter, false};
+}
+
+// Right-preconditioned BiCGSTAB; each iteration applies A and M twice.
+template <LinearOperator Operator,
+          PreconditionerFor Preconditioner = IdentityPreconditioner>
+IterativeResult bicgstab(
+  const Operator& a,
+  const std::vector<double>& b,
+  const Preconditioner& m = {},
+  double eps = 1e-10,
+  size_t max_iter = 10000,
+  std::vector<IterativeStep>* steps = nullptr
+) {
+  using namespace iterative_detail;
+  check_system(a.rows(), b.size(), b.size(), "bicgstab");
+  const size_t n = b.size();
+  const double b_norm = norm(b) == 0.0 ? 1.0 : norm(b);
+  std::vector<double> x(n, 0.0);
+  std::vector<double> r = b;
+  if (norm(r) <= eps * b_norm)
+    return {x, 0, true};
+  const std::vector<double> r_hat = r;
+  std::vector<double> p(n, 0.0);
+  std::vector<double> v(n, 0.0);
+  double rho = 1.0, alpha = 1.0, omega = 1.0;
+
+  for (size_t i = 0; i < max_iter; ++i) {
+    const double rho_new = dot(r_hat, r);
+    if (rho_new == 0.0 || omega == 0.0)
+      return {x, i, false};
+    const double beta = (rho_new / rho) * (alpha / omega);
+    rho = rho_new;
+    for (size_t k = 0; k < n; ++k) {
+      p[k] = r[k] + beta * (p[k] - omega * v[k]);
+    }
+
+    const std::vector<double> y = m.apply(p);
+    v = a.multiply(y);
+    const double denominator = dot(r_hat, v);
+    if (denominator == 0.0)
+      return {x, i, false};
+    alpha = rho / denominator;
+    add_scaled(x, alpha, y);
+    std::vector<double>& s = r;
+    add_scaled(s, -alpha, v);
+    if (norm(s) <= eps * b_norm) {
+      if (steps)
+        steps->push_back({i + 1, norm(s) / b_norm});
+      return {x, i + 1, true};
+    }
+
+    const std::vector<double> z = m.apply(s);
+    const std::vector<double> t = a.multiply(z);
+    const double tt = dot(t, t);
+    omega = tt == 0.0 ? 0.0 : dot(t, s) / tt;
+    add_scaled(x, omega, z);
+    add_scaled(r, -omega, t);
+
+    const double error = norm(r) / b_norm;
+    if (steps)
+      steps->push_back({i + 1, error});
+    if (error <= eps)
+      return {x, i + 1, true};
+  }
+  return {x, max_iter, false};
+}
+
+// Right-preconditioned GMRES restarted every `restart` iterations, with
+// modified Gram-Schmidt Arnoldi and Givens rotations, so the residual norm
+// is known after every iteration without forming x.
+template <LinearOperator Operator,
+          PreconditionerFor Preconditioner = IdentityPreconditioner>
+IterativeResult gmres(
+  const Operator& a,
+  const std::vector<double>& b,
+  const Preconditioner& m = {},
+  size_t restart = 30,
+  double eps = 1e-10,
+  size_t max_iter = 10000,
+  std::vector<IterativeStep>* steps = nullptr
+) {
+  using namespace iterative_detail;
+  check_system(a.rows(), b.size(), b.size(), "gmres");
+  if (restart == 0) {
+    throw std::invalid_argument("gmres restart must be positive");
+  }
+  const size_t n = b.size();
+  const double b_norm = norm(b) == 0.0 ? 1.0 : norm(b);
+  std::vector<double> x(n, 0.0);
+  size_t iteration = 0;
+
+  while (true) {
+    std::vector<double> r = b;
+    add_scaled(r, -1.0, a.multiply(x));
+    const double beta = norm(r);
+    if (beta <= eps * b_norm)
+      return {x, iteration, true};
+    if (iteration >= max_iter)
+      return {x, iteration, false};
+
+    std::vector<std::vector<double>> basis{r};
+    for (double& value : basis[0]) {
+      value /= beta;
+    }
+    std::vector<std::vector<double>> h;
+    std::vector<double> cs, sn;
+    std::vector<double> g{beta};
+
+    bool done = false;
+    for (size_t j = 0; j < restart && iteration < max_iter; ++j) {
+      ++iteration;
+      std::vector<double> w = a.multiply(m.apply(basis[j]));
+      std::vector<double> column(j + 2, 0.0);
+      for (size_t i = 0; i <= j; ++i) {
+        column[i] = dot(w, basis[i]);
+        add_scaled(w, -column[i], basis[i]);
+      }
+      column[j + 1] = norm(w);
+
+      for (size_t i = 0; i < j; ++i) {
+        const double upper = cs[i] * column[i] + sn[i] * column[i + 1];
+        column[i + 1] = -sn[i] * column[i] + cs[i] * column[i + 1];
+        column[i] = upper;
+      }
+      const double radius = std::hypot(column[j], column[j + 1]);
+      const double c = radius == 0.0 ? 1.0 : column[j] / radius;
+      const double s = radius == 0.0 ? 0.0 : column[j + 1] / radius;
+      const double next_norm = column[j + 1];
+      cs.push_back(c);
+      sn.push_back(s);
+      column[j] = radius;
+      column[j + 1] = 0.0;
+      g.push_back(-s * g[j]);
+      g[j] *= c;
+      h.push_back(std::move(column));
+
+      const double error = std::fabs(g[j + 1]) / b_norm;
+      if (steps)
+        steps->push_back({iteration, error});
+      if (error <= eps || next_norm == 0.0) {
+        done = true;
+        break;
+      }
+      for (double& value : w) {
+        value /= next_norm;
+      }
+      basis.push_back(std::move(w));
+    }
+
+    // y = H^-1 g by back substitution, then x += M^-1 (V y).
+    const size_t k = h.size();
+    std::vector<double> y(k);
+    for (size_t i = k; i-- > 0;) {
+      double sum = g[i];
+      for (size_t l = i + 1; l < k; ++l) {
+        sum -= h[l][i] * y[l];
+      }
+      y[i] = h[i][i] == 0.0 ? 0.0 : sum / h[i][i];
+    }
+    std::vector<double> update(n, 0.0);
+    for (size_t i = 0; i < k; ++i) {
+      add_scaled(update, y[i], basis[i]);
+    }
+    add_scaled(x, 1.0, m.apply(update));
+    if (done && std::fabs(g[k]) <= eps * b_norm)
+      return {x, iteration, true};
+  }
+}
+
+template <typename MatrixType>
+IterativeResult jacobi(
+  const MatrixType& a,
+  const std::vector<double>& b,
+  double eps = 1e-10,
+  size_t max_iter = 100000,
+  std::vector<IterativeStep>* steps = nullptr
+) {
+  using namespace iterative_detail;
+  check_system(a.rows(), a.cols(), b.size(), "jacobi");
+  const std::vector<double> diagonal = diagonal_of(a, "jacobi");
+  std::vector<double> x(b.size(), 0.0);
+  std::vector<double> x_new(b.size());
+  for (size_t i = 0; i < max_iter; ++i) {
+    double change = 0.0;
+    for (size_t row = 0; row < b.size(); ++row) {
+      double sum = b[row];
+      for_each_in_row(a, row, [&](size_t col, double value) {
+        if (col != row) {
+          sum -= value * x[col];
+        }
+      });
+      x_new[row] = sum / diagonal[row];
+      change = std::fmax(change, std::fabs(x_new[row] - x[row]));
+    }
+    x.swap(x_new);
+    if (steps)
+      steps->push_back({i + 1, change});
+    if (change < eps)
+      return {x, i + 1, true};
+  }
+  return {x, max_iter, false};
+}
+
+// Successive over-relaxation; omega = 1 is Gauss-Seidel.
+template <typename MatrixType>
+IterativeResult sor(
+  const MatrixType& a,
+  const std::vector<double>& b,
+  double omega,
+  double eps = 1e-10,
+  size_t max_iter = 100000,
+  std::vector<IterativeStep>* steps = nullptr
+) {
+  using namespace iterative_detail;
+  check_system(a.rows(), a.cols(), b.size(), "sor");
+  if (!(omega > 0.0 && omega < 2.0)) {
+    throw std::invalid_argument("SOR relaxation factor must lie in (0, 2)");
+  }
+  const std::vector<double> diagonal = diagonal_of(a, "sor");
+  std::vector<double> x(b.size(), 0.0);
+  for (size_t i = 0; i < max_iter; ++i) {
+    double change = 0.0;
+    for (size_t row = 0; row < b.size(); ++row) {
+      double sum = b[row];
+      for_each_in_row(a, row, [&](size_t col, double value) {
+        if (col != row) {
+          sum -= value * x[col];
+        }
+      });
+      const double updated =
+          (1.0 - omega) * x[row] + omega * sum / diagonal[row];
+      change = std::fmax(change, std::fabs(updated - x[row]));
+      x[row] = updated;
+    }
+    if (steps)
+      steps->push_back({i + 1, change});
+    if (change < eps)
+      return {x, i + 1, true};
+  }
+  return {x, max_iter, false};
+}
+
+template <typename MatrixType>
+IterativeResult gauss_seidel(
+  const MatrixType& a,
+  const std::vector<double>& b,
+  double eps = 1e-10,
+  size_t max_iter = 100000,
+  std::vector<IterativeStep>* steps = nullptr
+) {
+  return sor(a, b, 1.0, eps, max_iter, steps);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "MatrixBF.h"
+#include "bigmath/bigfloat.hpp"
+#include "polynomial.hpp"
+
+// Linear recurrences with constant coefficients
+//
+//   a(n) = c[0] a(n-1) + c[1] a(n-2) + ... + c[d-1] a(n-d),
+//
+// given by c and the initial terms a(0) .. a(d-1), in exact bigfloat.
+
+// Characteristic polynomial x^d - c[0] x^(d-1) - ... - c[d-1].
+inline Polynomial characteristic_polynomial(
+    const std::vector<bigfloat>& coefficients) {
+  const size_t d = coefficients.size();
+  std::vector<bigfloat> result(d + 1);
+  for (size_t i = 0; i < d; ++i)
+    result[d - 1 - i] = -coefficients[i];
+  result[d] = bigfloat(1);
+  return Polynomial(VectorBF(result));
+}
+
+// Companion matrix C with (a(n+d-1), ..., a(n)) = C^n (a(d-1), ..., a(0)).
+inline MatrixBF companion_matrix(const std::vector<bigfloat>& coefficients) {
+  const size_t d = coefficients.size();
+  MatrixBF result(d, d);
+  for (size_t j = 0; j < d; ++j)
+    result(0, j) = coefficients[j];
+  for (size_t i = 1; i < d; ++i)
+    result(i, i - 1) = bigfloat(1);
+  return result;
+}
+
+// a(k) by Fiduccia's method: x^k mod P, P the characteristic polynomial,
+// is sum r[i] x^i, and then a(k) = sum r[i] a(i). x^k is built by
+// squaring, so this costs O(d^2 log k) instead of the O(d^3 log k) of
+// companion_matrix(c).pow(k).
+inline bigfloat linear_recurrence_term(
+    const std::vector<bigfloat>& coefficients,
+    const std::vector<bigfloat>& initial,
+    size_t k) {
+  const size_t d = coefficients.size();
+  if (d == 0)
+    throw std::invalid_argument("linear_recurrence_term: empty recurrence");
+  if (initial.size() != d)
+    throw std::invalid_argument(
+        "linear_recurrence_term: need as many initial terms as coefficients");
+  if (k < d)
+    return initial[k];
+
+  const Polynomial modulus = characteristic_polynomial(coefficients);
+  const Polynomial x(VectorBF(std::vector<bigfloat>{bigfloat(0), bigfloat(1)}));
+  Polynomial power(VectorBF(std::vector<bigfloat>{bigfloat(1)}));
+  for (size_t bit = std::bit_width(k); bit-- > 0;) {
+    power = (power * power) % modulus;
+    if ((k >> bit) & 1)
+      power = (power * x) % modulus;
+  }
+
+  const VectorBF& r = power.coefficients();
+  bigfloat result(0);
+  for (size_t i = 0; i < r.dimension() && i < d; ++i)
+    result += r[i] * initial[i];
+  return result;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "BasicLUDecomposition.h"
+#include "BasicUpdatableLU.h"
+#include "matrix.hpp"
+
+// PA = LU in double, the counterpart of LUDecompositionBF.
+using LUDecomposition = BasicLUDecomposition<double>;
+// LU that absorbs low-rank updates, see BasicUpdatableLU.h.
+using UpdatableLU = BasicUpdatableLU<double>;
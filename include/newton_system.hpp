@@ -4,10 +4,12 @@
 #include <cmath>
 #include <cstddef>
 #include <functional>
+#include <type_traits>
 #include <vector>
 
 #include "vector.hpp"
 #include "matrix.hpp"
+#include "small_matrix.hpp"
 
 struct SystemResult {
   Vector solution;
@@ -44,6 +46,48 @@ inline SystemResult newton_system(
   return {x, max_iter, false};
 }
 
+template <size_t N>
+struct SmallSystemResult {
+  SmallVector<N> solution;
+  size_t iterations;
+  bool converged;
+};
+
+template <size_t N>
+struct SmallSystemStep {
+  size_t iteration;
+  SmallVector<N> approximation;
+};
+
+// Fixed-size overload for tiny systems: F returns SmallVector<N>, J returns
+// SmallMatrix<N> and both are called directly rather than through
+// std::function, so an iteration allocates nothing (recorded steps aside).
+template <size_t N, typename Function, typename Jacobian>
+  requires std::is_invocable_r_v<SmallVector<N>, const Function&,
+                                 const SmallVector<N>&> &&
+           std::is_invocable_r_v<SmallMatrix<N>, const Jacobian&,
+                                 const SmallVector<N>&>
+SmallSystemResult<N> newton_system(
+  const Function& F,
+  const Jacobian& J,
+  const SmallVector<N>& x0,
+  double eps = 1e-10,
+  size_t max_iter = 100000,
+  std::vector<SmallSystemStep<N>>* steps = nullptr
+) {
+  SmallVector<N> x = x0;
+  for (size_t i = 0; i < max_iter; ++i) {
+    const SmallVector<N> delta = J(x).solve(F(x));
+    const SmallVector<N> x_new = x - delta;
+    if (steps)
+      steps->push_back({i + 1, x_new});
+    if (F(x_new).norm() < eps && delta.norm() < eps)
+      return {x_new, i + 1, true};
+    x = x_new;
+  }
+  return {x, max_iter, false};
+}
+
 inline SystemResult newton_system_inf(
 
   const std::function<Vector(const Vector&)>& F,
@@ -79,3 +123,35 @@ inline SystemResult newton_system_inf(
   }
   return {x, max_iter, false};
 }
+
+// Fixed-size newton_system_inf. Each step solves J(x) delta = F(x) by
+// elimination instead of forming J(x)^-1, and iteration stops once the
+// largest component of delta is below eps.
+template <size_t N, typename Function, typename Jacobian>
+  requires std::is_invocable_r_v<SmallVector<N>, const Function&,
+                                 const SmallVector<N>&> &&
+           std::is_invocable_r_v<SmallMatrix<N>, const Jacobian&,
+                                 const SmallVector<N>&>
+SmallSystemResult<N> newton_system_inf(
+  const Function& F,
+  const Jacobian& J,
+  const SmallVector<N>& x0,
+  double eps = 1e-10,
+  size_t max_iter = 100000,
+  std::vector<SmallSystemStep<N>>* steps = nullptr
+) {
+  SmallVector<N> x = x0;
+  for (size_t i = 0; i < max_iter; ++i) {
+    const SmallVector<N> delta = J(x).solve(F(x));
+    const SmallVector<N> x_new = x - delta;
+    if (steps)
+      steps->push_back({i + 1, x_new});
+    double inf_norm = 0.0;
+    for (size_t k = 0; k < N; ++k)
+      inf_norm = std::fmax(inf_norm, std::fabs(delta[k]));
+    if (inf_norm < eps)
+      return {x_new, i + 1, true};
+    x = x_new;
+  }
+  return {x, max_iter, false};
+}
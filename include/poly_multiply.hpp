@@ -0,0 +1,417 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "fft.hpp"
+
+// Transform-based product for long operands, or nullopt when it cannot
+// vouch for the answer on these operands; PolyMultiplier then falls back
+// to Karatsuba and Toom-3. Coefficient types opt in by specialization.
+template <typename T>
+struct PolyTransform {
+  static constexpr bool available = false;
+  static std::optional<std::vector<T>> multiply(const std::vector<T>&,
+                                                const std::vector<T>&) {
+    return std::nullopt;
+  }
+};
+
+// Double FFT, held to kRelativeError times each coefficient of |a| * |b|
+// (the product of the coefficient magnitudes, which bounds |c_i| and is what
+// the schoolbook error scales with). A second convolution, of the
+// magnitudes, gives those within the same proven bound. Coefficients the
+// bound does not cover, typically the few at either end, are recomputed as
+// direct sums; when that would take more than n log2 n multiply-adds, as
+// with coefficients spanning a wide range, the product falls back.
+template <>
+struct PolyTransform<double> {
+  static constexpr bool available = true;
+  static constexpr double kRelativeError = 1e-10;
+
+  static std::optional<std::vector<double>> multiply(
+      const std::vector<double>& a, const std::vector<double>& b) {
+    const double bound = fft_convolution_error_bound(a, b);
+    std::vector<double> a_magnitude(a.size()), b_magnitude(b.size());
+    for (size_t i = 0; i < a.size(); ++i)
+      a_magnitude[i] = std::fabs(a[i]);
+    for (size_t i = 0; i < b.size(); ++i)
+      b_magnitude[i] = std::fabs(b[i]);
+    const std::vector<double> magnitude =
+        fft_convolution(a_magnitude, b_magnitude);
+
+    const size_t n = magnitude.size();
+    const size_t budget = n * std::bit_width(n);
+    size_t direct_terms = 0;
+    std::vector<size_t> direct;
+    for (size_t i = 0; i < n; ++i) {
+      if (bound <= kRelativeError * (magnitude[i] - bound))
+        continue;
+      direct_terms += std::min(i, a.size() - 1) + 1 -
+                      (i < b.size() ? 0 : i - b.size() + 1);
+      if (direct_terms > budget)
+        return std::nullopt;
+      direct.push_back(i);
+    }
+
+    std::vector<double> result = fft_convolution(a, b);
+    for (const size_t i : direct) {
+      double sum = 0.0;
+      for (size_t j = i < b.size() ? 0 : i - b.size() + 1;
+           j <= std::min(i, a.size() - 1); ++j)
+        sum += a[j] * b[i - j];
+      result[i] = sum;
+    }
+    return result;
+  }
+};
+
+// Coefficient-list products behind Polynomial (bigfloat) and PowerSeries
+// (double). Operands shorter than the Karatsuba crossover use the schoolbook
+// product, longer ones split in two (Karatsuba, 3 half-size products instead
+// of 4) and past the Toom-3 crossover in three (5 third-size products
+// instead of 9). An operand at least twice as long as the other is cut into
+// pieces the other's length first, so the splits always see balanced
+// halves.
+//
+// Toom-3 interpolates with Bodrato's sequence, which divides by 2 and 3:
+// exact for bigfloat, and for double no worse than the additions around it.
+// From the transform crossover on, PolyTransform<T> is tried first. Each
+// crossover is fixed for floating-point coefficients and measured once for
+// exact ones; see karatsuba_crossover().
+template <typename T>
+class PolyMultiplier {
+ private:
+  static constexpr size_t kKaratsubaSmallestCandidate = 8;
+  static constexpr size_t kKaratsubaLargestCandidate = 256;
+  static constexpr size_t kToom3SmallestCandidate = 64;
+  static constexpr size_t kToom3LargestCandidate = 1024;
+  static constexpr size_t kTransformSmallestCandidate = 64;
+  static constexpr size_t kTransformLargestCandidate = 4096;
+  static constexpr size_t kNever = std::numeric_limits<size_t>::max();
+
+  // Crossovers for floating-point coefficients, from bench_poly_multiply
+  // medians on x86-64 with AVX2.
+  static constexpr size_t kRoundedKaratsubaCrossover = 64;
+  static constexpr size_t kRoundedToom3Crossover = 256;
+  static constexpr size_t kRoundedTransformCrossover = 4096;
+  // A split algorithm must beat the one it replaces by this factor before
+  // tuning picks it, so near-ties do not flip from run to run.
+  static constexpr double kTuningMargin = 1.1;
+  static constexpr size_t kTuningSamples = 5;
+
+  static std::atomic<size_t>& karatsuba_override() {
+    static std::atomic<size_t> forced{0};
+    return forced;
+  }
+  static std::atomic<size_t>& toom3_override() {
+    static std::atomic<size_t> forced{0};
+    return forced;
+  }
+  static std::atomic<size_t>& transform_override() {
+    static std::atomic<size_t> forced{0};
+    return forced;
+  }
+
+  // out[0, na + nb - 1) += a * b.
+  static void multiply_into(const T* a, size_t na, const T* b, size_t nb,
+                            T* out, size_t karatsuba, size_t toom3) {
+    // The schoolbook product keeps the operands in the order given, so
+    // short products sum every coefficient exactly as before the splits.
+    if (std::min(na, nb) < std::max<size_t>(karatsuba, 2)) {
+      for (size_t i = 0; i < na; ++i)
+        for (size_t j = 0; j < nb; ++j)
+          out[i + j] += a[i] * b[j];
+      return;
+    }
+    if (na < nb) {
+      std::swap(a, b);
+      std::swap(na, nb);
+    }
+    if (na >= 2 * nb) {
+      for (size_t i = 0; i < na; i += nb)
+        multiply_into(a + i, std::min(nb, na - i), b, nb, out + i, karatsuba,
+                      toom3);
+      return;
+    }
+    // Toom-3 wants a nonempty top third in both operands.
+    if (nb >= toom3 && nb > 2 * ((na + 2) / 3)) {
+      multiply_toom3(a, na, b, nb, out, karatsuba, toom3);
+    } else {
+      multiply_karatsuba(a, na, b, nb, out, karatsuba, toom3);
+    }
+  }
+
+  // nb <= na < 2 nb, so both operands have a nonempty low half of length h.
+  // (a0 + a1 x^h)(b0 + b1 x^h) with the middle term from
+  // (a0 + a1)(b0 + b1) - a0 b0 - a1 b1.
+  static void multiply_karatsuba(const T* a, size_t na, const T* b, size_t nb,
+                                 T* out, size_t karatsuba, size_t toom3) {
+    const size_t h = (na + 1) / 2;
+    std::vector<T> low(2 * h - 1, T(0));
+    multiply_into(a, h, b, h, low.data(), karatsuba, toom3);
+    std::vector<T> high;
+    if (nb > h) {
+      high.assign(na + nb - 2 * h - 1, T(0));
+      multiply_into(a + h, na - h, b + h, nb - h, high.data(), karatsuba,
+                    toom3);
+    }
+
+    std::vector<T> a_sum(a, a + h);
+    std::vector<T> b_sum(b, b + h);
+    for (size_t i = h; i < na; ++i)
+      a_sum[i - h] += a[i];
+    for (size_t i = h; i < nb; ++i)
+      b_sum[i - h] += b[i];
+    std::vector<T> middle(2 * h - 1, T(0));
+    multiply_into(a_sum.data(), h, b_sum.data(), h, middle.data(), karatsuba,
+                  toom3);
+
+    for (size_t i = 0; i < low.size(); ++i) {
+      out[i] += low[i];
+      middle[i] -= low[i];
+    }
+    for (size_t i = 0; i < high.size(); ++i) {
+      out[2 * h + i] += high[i];
+      middle[i] -= high[i];
+    }
+    const size_t total = na + nb - 1;
+    for (size_t i = 0; i < middle.size() && h + i < total; ++i)
+      out[h + i] += middle[i];
+  }
+
+  // Thirds of length k, evaluated at 0, 1, -1, -2 and infinity.
+  static void multiply_toom3(const T* a, size_t na, const T* b, size_t nb,
+                             T* out, size_t karatsuba, size_t toom3) {
+    const size_t k = (na + 2) / 3;
+    const size_t length = 2 * k - 1;
+
+    // p(0) = p0, p(1), p(-1), p(-2) and p(inf) = p2, each k long.
+    const auto evaluate = [k](const T* p, size_t n) {
+      std::vector<std::vector<T>> values(5, std::vector<T>(k, T(0)));
+      for (size_t i = 0; i < k; ++i) {
+        const T p0 = p[i];
+        const T p1 = k + i < n ? p[k + i] : T(0);
+        const T p2 = 2 * k + i < n ? p[2 * k + i] : T(0);
+        const T even = p0 + p2;
+        values[0][i] = p0;
+        values[1][i] = even + p1;
+        values[2][i] = even - p1;
+        const T shifted = values[2][i] + p2;
+        values[3][i] = shifted + shifted - p0;
+        values[4][i] = p2;
+      }
+      return values;
+    };
+    const std::vector<std::vector<T>> pa = evaluate(a, na);
+    const std::vector<std::vector<T>> pb = evaluate(b, nb);
+
+    std::vector<std::vector<T>> r(5, std::vector<T>(length, T(0)));
+    for (size_t point = 0; point < 4; ++point)
+      multiply_into(pa[point].data(), k, pb[point].data(), k, r[point].data(),
+                    karatsuba, toom3);
+    multiply_into(a + 2 * k, na - 2 * k, b + 2 * k, nb - 2 * k, r[4].data(),
+                  karatsuba, toom3);
+
+    const T two(2);
+    const T three(3);
+    for (size_t i = 0; i < length; ++i) {
+      const T r0 = r[0][i];
+      const T r4 = r[4][i];
+      T r3 = (r[3][i] - r[1][i]) / three;
+      T r1 = (r[1][i] - r[2][i]) / two;
+      T r2 = r[2][i] - r0;
+      r3 = (r2 - r3) / two + r4 + r4;
+      r2 = r2 + r1 - r4;
+      r1 = r1 - r3;
+      r[1][i] = r1;
+      r[2][i] = r2;
+      r[3][i] = r3;
+    }
+
+    const size_t total = na + nb - 1;
+    for (size_t part = 0; part < 5; ++part)
+      for (size_t i = 0; i < length && part * k + i < total; ++i)
+        out[part * k + i] += r[part][i];
+  }
+
+  static std::vector<T> tuning_operand(size_t n, size_t seed) {
+    std::vector<T> result(n);
+    for (size_t i = 0; i < n; ++i)
+      result[i] = T(static_cast<int>((i * 31 + seed * 17) % 97) - 48);
+    return result;
+  }
+
+  // Median over kTuningSamples of the average time of one call, each
+  // sample repeating short calls so that timer resolution does not decide.
+  template <typename Call>
+  static double seconds_per_call(Call&& call) {
+    using clock = std::chrono::steady_clock;
+    std::vector<double> samples;
+    for (size_t sample = 0; sample < kTuningSamples; ++sample) {
+      size_t calls = 0;
+      const auto start = clock::now();
+      std::chrono::duration<double> elapsed{};
+      do {
+        call();
+        ++calls;
+        elapsed = clock::now() - start;
+      } while (elapsed < std::chrono::milliseconds(1));
+      samples.push_back(elapsed.count() / static_cast<double>(calls));
+    }
+    std::nth_element(samples.begin(), samples.begin() + kTuningSamples / 2,
+                     samples.end());
+    return samples[kTuningSamples / 2];
+  }
+
+  static double seconds_per_product(const std::vector<T>& a,
+                                    const std::vector<T>& b, size_t karatsuba,
+                                    size_t toom3) {
+    std::vector<T> out(a.size() + b.size() - 1, T(0));
+    return seconds_per_call([&] {
+      multiply_into(a.data(), a.size(), b.data(), b.size(), out.data(),
+                    karatsuba, toom3);
+    });
+  }
+
+ public:
+  // Coefficients of a * b, lowest degree first; empty if either is empty.
+  static std::vector<T> multiply(const std::vector<T>& a,
+                                 const std::vector<T>& b) {
+    if (a.empty() || b.empty())
+      return {};
+    // Operands shorter than every candidate never start the tuning.
+    const size_t shorter = std::min(a.size(), b.size());
+    if constexpr (PolyTransform<T>::available) {
+      if ((shorter >= kTransformSmallestCandidate ||
+           transform_override().load()) &&
+          shorter >= transform_crossover()) {
+        if (auto product = PolyTransform<T>::multiply(a, b))
+          return std::move(*product);
+      }
+    }
+    const size_t karatsuba =
+        shorter >= kKaratsubaSmallestCandidate || karatsuba_override().load()
+            ? karatsuba_crossover()
+            : kNever;
+    const size_t toom3 =
+        shorter >= kToom3SmallestCandidate || toom3_override().load()
+            ? toom3_crossover()
+            : kNever;
+    std::vector<T> result(a.size() + b.size() - 1, T(0));
+    multiply_into(a.data(), a.size(), b.data(), b.size(), result.data(),
+                  karatsuba, toom3);
+    return result;
+  }
+
+  // Shortest operand length at which multiply() leaves the schoolbook
+  // product for Karatsuba, and Karatsuba for Toom-3, unless forced with the
+  // setter (0 restores the default).
+  //
+  // For floating-point coefficients the algorithm decides how a product
+  // rounds, so these are the fixed kRounded* values and results do not
+  // depend on a timer. Other coefficient types are exact, give the same
+  // product either way, and are measured on the first product long enough
+  // to need the answer. Karatsuba: the first power of two at which one
+  // Karatsuba level beats the schoolbook product by kTuningMargin. Toom-3:
+  // the first at which one Toom-3 level beats Karatsuba all the way down by
+  // the same margin.
+  static size_t karatsuba_crossover() {
+    if (size_t forced = karatsuba_override().load())
+      return forced;
+    if constexpr (std::floating_point<T>) {
+      return kRoundedKaratsubaCrossover;
+    }
+    static std::once_flag tuned;
+    static size_t crossover = kKaratsubaLargestCandidate * 2;
+    std::call_once(tuned, [] {
+      for (size_t n = kKaratsubaSmallestCandidate;
+           n <= kKaratsubaLargestCandidate; n *= 2) {
+        const std::vector<T> a = tuning_operand(n, 1);
+        const std::vector<T> b = tuning_operand(n, 2);
+        if (kTuningMargin * seconds_per_product(a, b, n, kNever) <
+            seconds_per_product(a, b, kNever, kNever)) {
+          crossover = n;
+          break;
+        }
+      }
+    });
+    return crossover;
+  }
+
+  static size_t toom3_crossover() {
+    if (size_t forced = toom3_override().load())
+      return forced;
+    if constexpr (std::floating_point<T>) {
+      return kRoundedToom3Crossover;
+    }
+    static std::once_flag tuned;
+    static size_t crossover = kToom3LargestCandidate * 2;
+    std::call_once(tuned, [] {
+      const size_t karatsuba = karatsuba_crossover();
+      for (size_t n = kToom3SmallestCandidate; n <= kToom3LargestCandidate;
+           n *= 2) {
+        if (n < 3 * karatsuba)
+          continue;
+        const std::vector<T> a = tuning_operand(n, 1);
+        const std::vector<T> b = tuning_operand(n, 2);
+        if (kTuningMargin * seconds_per_product(a, b, karatsuba, n) <
+            seconds_per_product(a, b, karatsuba, kNever)) {
+          crossover = n;
+          break;
+        }
+      }
+    });
+    return crossover;
+  }
+
+  // Shortest operand length from which PolyTransform<T> is tried: fixed for
+  // floating-point coefficients as above, otherwise the first power of two
+  // at which it beats Karatsuba and Toom-3 by kTuningMargin.
+  static size_t transform_crossover() {
+    if (size_t forced = transform_override().load())
+      return forced;
+    if constexpr (std::floating_point<T>) {
+      return kRoundedTransformCrossover;
+    }
+    static std::once_flag tuned;
+    static size_t crossover = kTransformLargestCandidate * 2;
+    std::call_once(tuned, [] {
+      const size_t karatsuba = karatsuba_crossover();
+      const size_t toom3 = toom3_crossover();
+      for (size_t n = kTransformSmallestCandidate;
+           n <= kTransformLargestCandidate; n *= 2) {
+        const std::vector<T> a = tuning_operand(n, 1);
+        const std::vector<T> b = tuning_operand(n, 2);
+        if (!PolyTransform<T>::multiply(a, b))
+          continue;
+        const double transform =
+            seconds_per_call([&] { PolyTransform<T>::multiply(a, b); });
+        if (kTuningMargin * transform <
+            seconds_per_product(a, b, karatsuba, toom3)) {
+          crossover = n;
+          break;
+        }
+      }
+    });
+    return crossover;
+  }
+
+  static void set_karatsuba_crossover(size_t size) {
+    karatsuba_override() = size;
+  }
+  static void set_toom3_crossover(size_t size) { toom3_override() = size; }
+  static void set_transform_crossover(size_t size) {
+    transform_override() = size;
+  }
+};
@@ -3,10 +3,28 @@
 
 #include "bigmath/bigfloat.hpp"
 #include "VectorBF.h"
+#include <algorithm>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "modular_linalg.h"
+#include "poly_multiply.hpp"
 #include "poly_tostring.hpp"
 
+// Integer coefficients multiply exactly through the multi-prime NTT of
+// modular_convolution. Other bigfloat coefficients have no exact transform
+// and stay with Karatsuba and Toom-3.
+template <>
+struct PolyTransform<bigfloat> {
+  static constexpr bool available = true;
+
+  static std::optional<std::vector<bigfloat>> multiply(
+      const std::vector<bigfloat>& a, const std::vector<bigfloat>& b) {
+    return modular_convolution(a, b);
+  }
+};
+
 class Polynomial {
 private:
   VectorBF coeffs_;
@@ -105,10 +123,27 @@ public:
     const size_t gn = other.coeffs_.dimension();
     if (fn == 0 || gn == 0)
       return Polynomial(VectorBF(std::vector<bigfloat>{bigfloat(0)}));
-    std::vector<bigfloat> result(fn + gn - 1, bigfloat(0));
-    for (size_t i = 0; i < fn; ++i)
-      for (size_t j = 0; j < gn; ++j)
-        result[i + j] += coeffs_[i] * other.coeffs_[j];
+    return Polynomial(VectorBF(PolyMultiplier<bigfloat>::multiply(
+        coeffs_.components(), other.coeffs_.components())));
+  }
+
+  // Remainder of division by `divisor`, of degree below divisor.degree().
+  // Exact for bigfloat, so only the leading coefficient must be nonzero.
+  Polynomial operator%(const Polynomial& divisor) const {
+    if (divisor.is_zero())
+      throw std::domain_error("Polynomial division by zero");
+    const size_t d = divisor.degree();
+    const VectorBF& b = divisor.coeffs_;
+    std::vector<bigfloat> result = coeffs_.components();
+    for (size_t i = result.size(); i-- > d;) {
+      if (result[i] == bigfloat(0))
+        continue;
+      const bigfloat q = result[i] / b[d];
+      for (size_t j = 0; j < d; ++j)
+        result[i - d + j] -= q * b[j];
+      result[i] = bigfloat(0);
+    }
+    result.resize(std::max<size_t>(d, 1), bigfloat(0));
     return Polynomial(VectorBF(result));
   }
 
@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <vector>
 
+#include "poly_multiply.hpp"
+
 class PowerSeries {
 private:
     std::vector<double> coeffs_;
@@ -51,12 +53,8 @@ public:
     PowerSeries operator*(const PowerSeries &other) const {
         if (coeffs_.empty() || other.coeffs_.empty())
             return PowerSeries(std::vector<double>{0.0});
-        const size_t n = coeffs_.size() + other.coeffs_.size() - 1;
-        PowerSeries result(n);
-        for (size_t i = 0; i < coeffs_.size(); ++i)
-            for (size_t j = 0; j < other.coeffs_.size(); ++j)
-                result[i + j] += coeffs_[i] * other.coeffs_[j];
-        return result;
+        return PowerSeries(
+            PolyMultiplier<double>::multiply(coeffs_, other.coeffs_));
     }
 
     PowerSeries operator*(double scalar) const {
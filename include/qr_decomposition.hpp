@@ -0,0 +1,8 @@
+#pragma once
+
+#include "BasicQRDecomposition.h"
+#include "matrix.hpp"
+#include "vector.hpp"
+
+// A P = QR in double, the counterpart of QRDecompositionBF.
+using QRDecomposition = BasicQRDecomposition<double>;
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+// Fixed-size double vectors and square matrices for tiny systems (2x2 to
+// 4x4 Newton steps and the like). Storage is a std::array on the stack and
+// every loop has a compile-time trip count, so nothing allocates and the
+// elimination in SmallMatrix::solve is unrolled per pivot step.
+//
+// operator[] and operator() are unchecked like std::array's; at() checks.
+
+template <size_t N>
+class SmallVector {
+ private:
+  std::array<double, N> data_{};
+
+ public:
+  constexpr SmallVector() = default;
+  template <std::convertible_to<double>... Values>
+    requires(sizeof...(Values) == N)
+  constexpr SmallVector(Values... values)
+      : data_{static_cast<double>(values)...} {}
+
+  static constexpr size_t dimension() noexcept { return N; }
+  constexpr const std::array<double, N>& components() const noexcept {
+    return data_;
+  }
+
+  constexpr double& operator[](size_t index) noexcept { return data_[index]; }
+  constexpr const double& operator[](size_t index) const noexcept {
+    return data_[index];
+  }
+  constexpr double& at(size_t index) {
+    if (index >= N) {
+      throw std::out_of_range("Vector index out of range");
+    }
+    return data_[index];
+  }
+  constexpr const double& at(size_t index) const {
+    if (index >= N) {
+      throw std::out_of_range("Vector index out of range");
+    }
+    return data_[index];
+  }
+
+  constexpr SmallVector& operator+=(const SmallVector& other) noexcept {
+    for (size_t i = 0; i < N; ++i) {
+      data_[i] += other.data_[i];
+    }
+    return *this;
+  }
+  constexpr SmallVector& operator-=(const SmallVector& other) noexcept {
+    for (size_t i = 0; i < N; ++i) {
+      data_[i] -= other.data_[i];
+    }
+    return *this;
+  }
+  constexpr SmallVector& operator*=(double scalar) noexcept {
+    for (size_t i = 0; i < N; ++i) {
+      data_[i] *= scalar;
+    }
+    return *this;
+  }
+
+  friend constexpr SmallVector operator+(SmallVector lhs,
+                                         const SmallVector& rhs) noexcept {
+    return lhs += rhs;
+  }
+  friend constexpr SmallVector operator-(SmallVector lhs,
+                                         const SmallVector& rhs) noexcept {
+    return lhs -= rhs;
+  }
+  friend constexpr SmallVector operator*(SmallVector vector,
+                                         double scalar) noexcept {
+    return vector *= scalar;
+  }
+  friend constexpr SmallVector operator*(double scalar,
+                                         SmallVector vector) noexcept {
+    return vector *= scalar;
+  }
+  constexpr SmallVector operator-() const noexcept {
+    return SmallVector(*this) *= -1.0;
+  }
+
+  friend constexpr bool operator==(const SmallVector&,
+                                   const SmallVector&) = default;
+
+  constexpr double dot(const SmallVector& other) const noexcept {
+    double sum = 0.0;
+    for (size_t i = 0; i < N; ++i) {
+      sum += data_[i] * other.data_[i];
+    }
+    return sum;
+  }
+  double norm() const { return std::sqrt(dot(*this)); }
+};
+
+template <size_t N>
+class SmallMatrix {
+ private:
+  // Row-major, element (i, j) lives at data_[i * N + j].
+  std::array<double, N * N> data_{};
+
+  static constexpr double magnitude(double value) noexcept {
+    return value < 0.0 ? -value : value;
+  }
+
+  // Pivot step K of Gaussian elimination on a | b with partial pivoting.
+  template <size_t K>
+  static constexpr void eliminate(SmallMatrix& a, SmallVector<N>& b) {
+    size_t sel = K;
+    for (size_t i = K + 1; i < N; ++i) {
+      if (magnitude(a(i, K)) > magnitude(a(sel, K))) {
+        sel = i;
+      }
+    }
+    if (a(sel, K) == 0.0) {
+      throw std::runtime_error("No unique solution");
+    }
+    if (sel != K) {
+      for (size_t j = K; j < N; ++j) {
+        std::swap(a(K, j), a(sel, j));
+      }
+      std::swap(b[K], b[sel]);
+    }
+    for (size_t i = K + 1; i < N; ++i) {
+      const double factor = a(i, K) / a(K, K);
+      for (size_t j = K + 1; j < N; ++j) {
+        a(i, j) -= factor * a(K, j);
+      }
+      b[i] -= factor * b[K];
+    }
+  }
+
+  // Back substitution for row K of the upper triangular system.
+  template <size_t K>
+  static constexpr void substitute(const SmallMatrix& a, SmallVector<N>& x) {
+    for (size_t j = K + 1; j < N; ++j) {
+      x[K] -= a(K, j) * x[j];
+    }
+    x[K] /= a(K, K);
+  }
+
+ public:
+  constexpr SmallMatrix() = default;
+  // SmallMatrix<2>({{a, b}, {c, d}}).
+  constexpr SmallMatrix(const double (&rows)[N][N]) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < N; ++j) {
+        data_[i * N + j] = rows[i][j];
+      }
+    }
+  }
+
+  static constexpr SmallMatrix identity() noexcept {
+    SmallMatrix result;
+    for (size_t i = 0; i < N; ++i) {
+      result(i, i) = 1.0;
+    }
+    return result;
+  }
+
+  static constexpr size_t rows() noexcept { return N; }
+  static constexpr size_t cols() noexcept { return N; }
+
+  constexpr double& operator()(size_t row, size_t col) noexcept {
+    return data_[row * N + col];
+  }
+  constexpr const double& operator()(size_t row, size_t col) const noexcept {
+    return data_[row * N + col];
+  }
+  constexpr double& at(size_t row, size_t col) {
+    if (row >= N || col >= N) {
+      throw std::out_of_range("Matrix index out of range");
+    }
+    return data_[row * N + col];
+  }
+  constexpr const double& at(size_t row, size_t col) const {
+    if (row >= N || col >= N) {
+      throw std::out_of_range("Matrix index out of range");
+    }
+    return data_[row * N + col];
+  }
+
+  friend constexpr SmallVector<N> operator*(const SmallMatrix& matrix,
+                                            const SmallVector<N>& vector) {
+    SmallVector<N> result;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < N; ++j) {
+        result[i] += matrix(i, j) * vector[j];
+      }
+    }
+    return result;
+  }
+
+  friend constexpr bool operator==(const SmallMatrix&,
+                                   const SmallMatrix&) = default;
+
+  // Gaussian elimination with partial pivoting; throws
+  // std::runtime_error("No unique solution") on an exactly zero pivot.
+  constexpr SmallVector<N> solve(const SmallVector<N>& b) const {
+    SmallMatrix a = *this;
+    SmallVector<N> x = b;
+    [&]<size_t... K>(std::index_sequence<K...>) {
+      (eliminate<K>(a, x), ...);
+      (substitute<N - 1 - K>(a, x), ...);
+    }(std::make_index_sequence<N>{});
+    return x;
+  }
+
+  constexpr double determinant() const {
+    SmallMatrix a = *this;
+    double det = 1.0;
+    for (size_t k = 0; k < N; ++k) {
+      size_t sel = k;
+      for (size_t i = k + 1; i < N; ++i) {
+        if (magnitude(a(i, k)) > magnitude(a(sel, k))) {
+          sel = i;
+        }
+      }
+      if (a(sel, k) == 0.0) {
+        return 0.0;
+      }
+      if (sel != k) {
+        for (size_t j = k; j < N; ++j) {
+          std::swap(a(k, j), a(sel, j));
+        }
+        det = -det;
+      }
+      det *= a(k, k);
+      for (size_t i = k + 1; i < N; ++i) {
+        const double factor = a(i, k) / a(k, k);
+        for (size_t j = k + 1; j < N; ++j) {
+          a(i, j) -= factor * a(k, j);
+        }
+      }
+    }
+    return det;
+  }
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "BasicSpanBasis.h"
+#include "vector.hpp"
+
+// Incremental span basis over double; SpanBasisBF is the bigfloat instance.
+using SpanBasis = BasicSpanBasis<double>;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "BasicSparseLU.h"
+#include "BasicSparseMatrix.h"
+
+// Sparse double matrix and its LU; the bigfloat instances are
+// SparseMatrixBF and SparseLUBF, see third_party/linal-sdk.
+using SparseMatrix = BasicSparseMatrix<double>;
+using SparseLU = BasicSparseLU<double>;
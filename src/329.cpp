@@ -4,14 +4,13 @@
 #include <string>
 #include <vector>
 
-#include "matrix.hpp"
 #include "newton_system.hpp"
-#include "vector.hpp"
+#include "small_matrix.hpp"
 
 static const double PI = std::acos(-1.0);
 
 
-void print_steps(const std::vector<SystemStep>& steps) {
+void print_steps(const std::vector<SmallSystemStep<2>>& steps) {
   for (const auto& s : steps)
     std::cout << "    [" << std::setw(3) << s.iteration << "]  x="
       << std::fixed << std::setprecision(10) << s.approximation[0]
@@ -37,25 +36,25 @@ int main() {
 
   for (const auto& c : cases_a) {
     std::cout << c.name << "\n";
-    auto F = [&](const Vector& v) -> Vector {
+    auto F = [&](const SmallVector<2>& v) -> SmallVector<2> {
       double x = v[0], y = v[1];
-      return Vector{
+      return SmallVector<2>{
         std::tan(x * y + c.A) - x * x,
         x * x / c.a2 + y * y / c.b2 - 1.0
       };
     };
-    auto J = [&](const Vector& v) -> Matrix {
+    auto J = [&](const SmallVector<2>& v) -> SmallMatrix<2> {
       double x = v[0], y = v[1];
       double cs2 = std::cos(x * y + c.A);
       cs2 *= cs2;
-      return Matrix({
+      return SmallMatrix<2>({
         {y / cs2 - 2 * x, x / cs2},
         {2 * x / c.a2, 2 * y / c.b2}
       });
     };
     for (auto [x0, y0] : c.x0s) {
-      std::vector<SystemStep> steps;
-      auto r = newton_system(F, J, Vector{x0, y0}, eps, 100000, &steps);
+      std::vector<SmallSystemStep<2>> steps;
+      auto r = newton_system(F, J, SmallVector<2>{x0, y0}, eps, 100000, &steps);
       std::cout << "  x0=(" << std::fixed << std::setprecision(2) << x0 << ","
         << std::setw(5) << y0 << ")  ";
       if (r.converged)
@@ -70,24 +69,24 @@ int main() {
 
   std::cout << "=== b) x1^2 + x2^2 = 2,  e^(x1-1) + x2^3 = 2 ===\n\n";
 
-  auto Fb = [](const Vector& v) -> Vector {
+  auto Fb = [](const SmallVector<2>& v) -> SmallVector<2> {
     double x = v[0], y = v[1];
-    return Vector{
+    return SmallVector<2>{
       x * x + y * y - 2.0,
       std::exp(x - 1.0) + y * y * y - 2.0
     };
   };
-  auto Jb = [](const Vector& v) -> Matrix {
+  auto Jb = [](const SmallVector<2>& v) -> SmallMatrix<2> {
     double x = v[0], y = v[1];
-    return Matrix({
+    return SmallMatrix<2>({
       {2 * x, 2 * y},
       {std::exp(x - 1.0), 3 * y * y}
     });
   };
 
   for (auto [x0, y0] : std::vector<std::pair<double, double>>{{1.0, 1.0}, {0.5, 1.2}, {-1.0, 1.0}}) {
-    std::vector<SystemStep> steps;
-    auto r = newton_system(Fb, Jb, Vector{x0, y0}, eps, 100000, &steps);
+    std::vector<SmallSystemStep<2>> steps;
+    auto r = newton_system(Fb, Jb, SmallVector<2>{x0, y0}, eps, 100000, &steps);
     std::cout << "  x0=(" << std::fixed << std::setprecision(2) << x0 << ","
       << std::setw(5) << y0 << ")  ";
     if (r.converged) {
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "MatrixBF.h"
+
+// Bareiss (FRACTION_FREE) against division elimination on random integer
+// MatrixBF systems of size 50 to 300: determinant, solve_gauss and rank,
+// with the two answers compared exactly.
+
+double milliseconds_per_call(const std::function<void()> &call) {
+    using Clock = std::chrono::steady_clock;
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    do {
+        call();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 200.0);
+    return elapsed.count() / static_cast<double>(calls);
+}
+
+void print_row(const char *operation, double division, double bareiss, bool same) {
+    std::cout << std::setw(14) << operation << std::setw(14) << division << std::setw(14)
+              << bareiss << std::setw(9) << division / bareiss << "x" << std::setw(8)
+              << (same ? "same" : "DIFFER") << "\n";
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<int> entry(-99, 99);
+    bool agree = true;
+    std::cout << "integer MatrixBF, entries in [-99, 99] (ms per call)\n";
+    for (const size_t n : {50, 100, 200, 300}) {
+        MatrixBF a(n, n);
+        std::vector<bigfloat> b(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) a(i, j) = bigfloat(entry(rng));
+            b[i] = bigfloat(entry(rng));
+        }
+        // The first row repeated in the last, so the rank is n - 1.
+        MatrixBF deficient = a;
+        for (size_t j = 0; j < n; ++j) deficient(n - 1, j) = a(0, j);
+
+        std::cout << "n = " << n << "\n"
+                  << std::setw(14) << "" << std::setw(14) << "division" << std::setw(14)
+                  << "bareiss" << std::setw(10) << "speedup" << std::setw(8) << "result"
+                  << "\n"
+                  << std::fixed << std::setprecision(2);
+
+        bigfloat det_division, det_bareiss;
+        const double det_slow = milliseconds_per_call(
+            [&] { det_division = a.determinant(Elimination::DIVISION); });
+        const double det_fast = milliseconds_per_call(
+            [&] { det_bareiss = a.determinant(Elimination::FRACTION_FREE); });
+        print_row("determinant", det_slow, det_fast, det_division == det_bareiss);
+        agree = agree && det_division == det_bareiss;
+
+        std::vector<bigfloat> x_division, x_bareiss;
+        const double solve_slow = milliseconds_per_call(
+            [&] { x_division = a.solve_gauss(b, Elimination::DIVISION); });
+        const double solve_fast = milliseconds_per_call(
+            [&] { x_bareiss = a.solve_gauss(b, Elimination::FRACTION_FREE); });
+        print_row("solve_gauss", solve_slow, solve_fast, x_division == x_bareiss);
+        agree = agree && x_division == x_bareiss;
+
+        size_t rank_division = 0, rank_bareiss = 0;
+        const double rank_slow = milliseconds_per_call(
+            [&] { rank_division = deficient.rank(Elimination::DIVISION); });
+        const double rank_fast = milliseconds_per_call(
+            [&] { rank_bareiss = deficient.rank(Elimination::FRACTION_FREE); });
+        print_row("rank", rank_slow, rank_fast, rank_division == rank_bareiss);
+        agree = agree && rank_division == rank_bareiss;
+    }
+    return agree ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,101 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+
+#include "MatrixBF.h"
+#include "VectorBF.h"
+
+// Heap allocations and time per iteration of Newton-style update loops on
+// VectorBF and MatrixBF: the fused expression templates against the same
+// expressions with every operator evaluated into a temporary, as the eager
+// operators did. Allocations are counted by replacing the global operator
+// new (plain and aligned), so they include those made inside bigfloat.
+
+namespace {
+size_t allocations = 0;
+}
+
+void *operator new(size_t size) {
+    ++allocations;
+    if (void *memory = std::malloc(size == 0 ? 1 : size)) return memory;
+    throw std::bad_alloc();
+}
+void *operator new(size_t size, std::align_val_t alignment) {
+    ++allocations;
+    const size_t align = static_cast<size_t>(alignment);
+    if (void *memory = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return memory;
+    throw std::bad_alloc();
+}
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+
+constexpr size_t kIterations = 200;
+
+// Allocations and microseconds per call of `update`, repeated kIterations
+// times.
+template <typename Update>
+void measure(const char *label, Update update) {
+    using Clock = std::chrono::steady_clock;
+    const size_t before = allocations;
+    const auto start = Clock::now();
+    for (size_t k = 0; k < kIterations; ++k) update();
+    const std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    std::cout << "  " << std::left << std::setw(34) << label << std::right << std::setw(12)
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(allocations - before) / kIterations << std::setw(12)
+              << elapsed.count() / kIterations << "\n";
+}
+
+void print_header(const char *title) {
+    std::cout << title << "\n  " << std::left << std::setw(34) << "" << std::right
+              << std::setw(12) << "allocs/iter" << std::setw(12) << "us/iter" << "\n";
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<int> numerator(-999, 999);
+    const auto random_value = [&] { return bigfloat(numerator(rng)) / bigfloat(1000); };
+    const bigfloat step = bigfloat(1) / bigfloat(2);
+    const bigfloat t = bigfloat(1) / bigfloat(1000);
+
+    for (const size_t n : {16, 256}) {
+        VectorBF x(n), delta(n), g(n);
+        for (size_t i = 0; i < n; ++i) {
+            x[i] = random_value();
+            delta[i] = random_value();
+            g[i] = random_value();
+        }
+        std::cout << "n = " << n << "\n";
+        print_header("x = x - delta");
+        measure("fused", [&] { x = x - delta; });
+        measure("one temporary per operator", [&] { x = (x - delta).eval(); });
+        print_header("x = x - step * (delta + t * g)");
+        measure("fused", [&] { x = x - step * (delta + t * g); });
+        measure("one temporary per operator",
+                [&] { x = (x - (step * (delta + (t * g).eval()).eval()).eval()).eval(); });
+        std::cout << "\n";
+    }
+
+    for (const size_t n : {16, 64}) {
+        MatrixBF a(n, n), ab(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                a(i, j) = random_value();
+                ab(i, j) = random_value();
+            }
+        }
+        std::cout << "n = " << n << "\n";
+        print_header("a = a + ab * t");
+        measure("fused", [&] { a = a + ab * t; });
+        measure("one temporary per operator", [&] { a = (a + (ab * t).eval()).eval(); });
+        std::cout << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "lu_decomposition.hpp"
+#include "matrix.hpp"
+#include "parallel_for.h"
+
+// The blocked, partially pivoted LU against the elimination Matrix used
+// before it, which took the first nonzero pivot: forward and backward
+// errors on systems with small leading pivots, then factor and multi-RHS
+// solve times for 1, 2, 4, ... worker threads.
+
+double milliseconds_per_call(const std::function<void()> &call) {
+    using Clock = std::chrono::steady_clock;
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    do {
+        call();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 300.0);
+    return elapsed.count() / static_cast<double>(calls);
+}
+
+// The former Matrix::solve_gauss: first nonzero pivot, no row scaling.
+std::vector<double> first_nonzero_pivot_solve(const Matrix &matrix, std::vector<double> x) {
+    const size_t n = matrix.rows();
+    std::vector<std::vector<double>> a(n, std::vector<double>(n));
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) a[i][j] = matrix(i, j);
+    for (size_t i = 0; i < n; ++i) {
+        size_t pivot = i;
+        while (pivot < n && a[pivot][i] == 0.0) ++pivot;
+        if (pivot == n) throw std::runtime_error("No unique solution");
+        if (pivot != i) {
+            std::swap(a[i], a[pivot]);
+            std::swap(x[i], x[pivot]);
+        }
+        for (size_t j = i + 1; j < n; ++j) {
+            const double factor = a[j][i] / a[i][i];
+            for (size_t k = i; k < n; ++k) a[j][k] -= factor * a[i][k];
+            x[j] -= factor * x[i];
+        }
+    }
+    std::vector<double> result(n);
+    for (size_t i = n; i-- > 0;) {
+        double sum = x[i];
+        for (size_t j = i + 1; j < n; ++j) sum -= a[i][j] * result[j];
+        result[i] = sum / a[i][i];
+    }
+    return result;
+}
+
+std::vector<double> times(const Matrix &a, const std::vector<double> &x) {
+    std::vector<double> y(a.rows(), 0.0);
+    for (size_t i = 0; i < a.rows(); ++i)
+        for (size_t j = 0; j < a.cols(); ++j) y[i] += a(i, j) * x[j];
+    return y;
+}
+
+double max_norm(const std::vector<double> &v) {
+    double result = 0.0;
+    for (double value : v) result = std::max(result, std::fabs(value));
+    return result;
+}
+
+// ||x - exact|| / ||exact|| and ||b - A x|| / (||A|| ||x|| + ||b||), in the
+// max norm.
+std::pair<double, double> errors(const Matrix &a, const std::vector<double> &b,
+                                 const std::vector<double> &exact, const std::vector<double> &x) {
+    std::vector<double> difference(x.size());
+    for (size_t i = 0; i < x.size(); ++i) difference[i] = x[i] - exact[i];
+    std::vector<double> residual = times(a, x);
+    double a_norm = 0.0;
+    for (size_t i = 0; i < a.rows(); ++i) {
+        residual[i] = b[i] - residual[i];
+        double row = 0.0;
+        for (size_t j = 0; j < a.cols(); ++j) row += std::fabs(a(i, j));
+        a_norm = std::max(a_norm, row);
+    }
+    return {max_norm(difference) / max_norm(exact),
+            max_norm(residual) / (a_norm * max_norm(x) + max_norm(b))};
+}
+
+Matrix random_matrix(size_t n, std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> entry(-1.0, 1.0);
+    Matrix a(n, n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) a(i, j) = entry(rng);
+    return a;
+}
+
+void compare_stability(const char *label, const Matrix &a, std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> entry(-1.0, 1.0);
+    std::vector<double> exact(a.rows());
+    for (double &value : exact) value = entry(rng);
+    const std::vector<double> b = times(a, exact);
+    const auto [old_forward, old_backward] =
+        errors(a, b, exact, first_nonzero_pivot_solve(a, b));
+    const auto [lu_forward, lu_backward] = errors(a, b, exact, LUDecomposition(a).solve(b));
+    std::cout << "  " << std::left << std::setw(30) << label << std::right << std::scientific
+              << std::setprecision(2) << std::setw(12) << old_forward << std::setw(12)
+              << old_backward << std::setw(12) << lu_forward << std::setw(12) << lu_backward
+              << "\n";
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    std::cout << "forward / backward error, first nonzero pivot against partial pivoting\n"
+              << "  " << std::setw(30) << "" << std::setw(12) << "old fwd" << std::setw(12)
+              << "old bwd" << std::setw(12) << "lu fwd" << std::setw(12) << "lu bwd" << "\n";
+    compare_stability("[[1e-20, 1], [1, 1]]", Matrix({{1e-20, 1.0}, {1.0, 1.0}}), rng);
+    for (const size_t n : {50, 200}) {
+        const Matrix a = random_matrix(n, rng);
+        compare_stability(("random, n = " + std::to_string(n)).c_str(), a, rng);
+        Matrix small_pivots = a;
+        for (size_t i = 0; i < n; ++i) small_pivots(i, i) *= 1e-10;
+        compare_stability(("diagonal * 1e-10, n = " + std::to_string(n)).c_str(), small_pivots,
+                          rng);
+    }
+
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "\nfactor and n-column solve (ms), " << hardware << " hardware threads\n"
+              << std::setw(6) << "n" << std::setw(9) << "threads" << std::setw(12) << "factor"
+              << std::setw(10) << "speedup" << std::setw(12) << "solve" << std::setw(10)
+              << "speedup" << "\n";
+    for (const size_t n : {256, 512, 1024}) {
+        const Matrix a = random_matrix(n, rng);
+        const Matrix rhs = random_matrix(n, rng);
+        double factor_serial = 0.0, solve_serial = 0.0;
+        for (size_t threads = 1; threads <= hardware; threads *= 2) {
+            set_parallel_workers(threads);
+            const double factor = milliseconds_per_call([&] { LUDecomposition lu(a); });
+            const LUDecomposition lu(a);
+            const double solve = milliseconds_per_call([&] { (void)lu.solve(rhs); });
+            if (threads == 1) {
+                factor_serial = factor;
+                solve_serial = solve;
+            }
+            std::cout << std::setw(6) << n << std::setw(9) << threads << std::fixed
+                      << std::setprecision(2) << std::setw(12) << factor << std::setw(9)
+                      << factor_serial / factor << "x" << std::setw(12) << solve << std::setw(9)
+                      << solve_serial / solve << "x\n";
+        }
+    }
+    set_parallel_workers(0);
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "MatrixBF.h"
+
+// MatrixBF products: integer matrices go through the multi-modular engine on
+// every core, and the same matrices with one entry made fractional stay on
+// the bigfloat kernels on the calling thread. Each modular product is
+// checked against A (B x) for random integer vectors x.
+
+double milliseconds_per_call(const std::function<void()> &call) {
+    using Clock = std::chrono::steady_clock;
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    do {
+        call();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 200.0);
+    return elapsed.count() / static_cast<double>(calls);
+}
+
+MatrixBF random_integer_matrix(size_t n, int range, std::mt19937_64 &rng) {
+    std::uniform_int_distribution<int> entry(-range, range);
+    MatrixBF result(n, n);
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = 0; j < n; ++j) result(i, j) = bigfloat(entry(rng));
+    return result;
+}
+
+// m x in plain bigfloat arithmetic.
+std::vector<bigfloat> times(const MatrixBF &m, const std::vector<bigfloat> &x) {
+    std::vector<bigfloat> y(m.rows(), bigfloat(0));
+    for (size_t i = 0; i < m.rows(); ++i)
+        for (size_t j = 0; j < m.cols(); ++j) y[i] += m(i, j) * x[j];
+    return y;
+}
+
+// (A B) x == A (B x) for a few random x.
+bool matches(const MatrixBF &a, const MatrixBF &b, const MatrixBF &product,
+             std::mt19937_64 &rng) {
+    std::uniform_int_distribution<int> entry(-9, 9);
+    for (int trial = 0; trial < 3; ++trial) {
+        std::vector<bigfloat> x(b.cols());
+        for (bigfloat &value : x) value = bigfloat(entry(rng));
+        const std::vector<bigfloat> expected = times(a, times(b, x));
+        const std::vector<bigfloat> actual = times(product, x);
+        for (size_t i = 0; i < expected.size(); ++i) {
+            if (expected[i] != actual[i]) return false;
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    bool exact = true;
+    std::cout << "MatrixBF products, " << std::thread::hardware_concurrency()
+              << " hardware threads (ms per product)\n"
+              << std::setw(6) << "n" << std::setw(10) << "entries" << std::setw(14) << "bigfloat"
+              << std::setw(14) << "modular" << std::setw(10) << "speedup" << std::setw(8)
+              << "check" << "\n";
+    for (const int range : {100, 1000000}) {
+        for (size_t n = 16; n <= 256; n *= 2) {
+            const MatrixBF a = random_integer_matrix(n, range, rng);
+            const MatrixBF b = random_integer_matrix(n, range, rng);
+            // One fractional entry keeps the product off the modular engine.
+            MatrixBF a_fraction = a;
+            a_fraction(0, 0) += bigfloat(1) / bigfloat(2);
+
+            MatrixBF product;
+            const double modular = milliseconds_per_call([&] { product = a * b; });
+            const double kernel = milliseconds_per_call([&] { (void)(a_fraction * b); });
+            const bool ok = matches(a, b, product, rng);
+            exact = exact && ok;
+            std::cout << std::setw(6) << n << std::setw(10) << range << std::fixed
+                      << std::setprecision(2) << std::setw(14) << kernel << std::setw(14)
+                      << modular << std::setw(9) << kernel / modular << "x" << std::setw(8)
+                      << (ok ? "ok" : "FAIL") << "\n";
+        }
+    }
+    return exact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
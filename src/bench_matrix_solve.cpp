@@ -0,0 +1,128 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "MatrixBF.h"
+
+// MatrixBF solve_gauss (division elimination) and inverse on the contiguous
+// row-major storage, against the same algorithms on the nested
+// std::vector<std::vector<bigfloat>> storage with bounds-checked at() that
+// MatrixBF used before. Both pairs perform the same operations in the same
+// order, so their results are compared exactly.
+
+using Nested = std::vector<std::vector<bigfloat>>;
+
+double milliseconds_per_call(const std::function<void()> &call) {
+    using Clock = std::chrono::steady_clock;
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    do {
+        call();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 200.0);
+    return elapsed.count() / static_cast<double>(calls);
+}
+
+// The former MatrixBF::solve_gauss: first nonzero pivot, rows swapped as
+// whole vectors.
+std::vector<bigfloat> nested_solve_gauss(Nested a, std::vector<bigfloat> x) {
+    const size_t n = a.size();
+    for (size_t i = 0; i < n; ++i) {
+        size_t pivot = i;
+        while (pivot < n && a.at(pivot).at(i) == 0) ++pivot;
+        if (pivot == n) throw std::runtime_error("No unique solution");
+        if (pivot != i) {
+            std::swap(a[i], a[pivot]);
+            std::swap(x[i], x[pivot]);
+        }
+        for (size_t j = i + 1; j < n; ++j) {
+            bigfloat factor = a.at(j).at(i) / a.at(i).at(i);
+            for (size_t k = i; k < n; ++k) a.at(j).at(k) -= factor * a.at(i).at(k);
+            x[j] -= factor * x[i];
+        }
+    }
+    std::vector<bigfloat> result(n);
+    for (size_t i = n; i-- > 0;) {
+        bigfloat sum = x[i];
+        for (size_t j = i + 1; j < n; ++j) sum -= a.at(i).at(j) * result[j];
+        result[i] = sum / a.at(i).at(i);
+    }
+    return result;
+}
+
+// The former MatrixBF::inverse: Gauss-Jordan on [A | I].
+Nested nested_inverse(Nested a) {
+    const size_t n = a.size();
+    Nested inv(n, std::vector<bigfloat>(n, bigfloat(0)));
+    for (size_t i = 0; i < n; ++i) inv.at(i).at(i) = 1;
+    for (size_t i = 0; i < n; ++i) {
+        size_t pivot = i;
+        while (pivot < n && a.at(pivot).at(i) == 0) ++pivot;
+        if (pivot == n) throw std::runtime_error("Singular matrix");
+        if (pivot != i) {
+            std::swap(a[i], a[pivot]);
+            std::swap(inv[i], inv[pivot]);
+        }
+        const bigfloat div = a.at(i).at(i);
+        for (size_t j = 0; j < n; ++j) {
+            a.at(i).at(j) /= div;
+            inv.at(i).at(j) /= div;
+        }
+        for (size_t j = 0; j < n; ++j) {
+            if (i == j) continue;
+            const bigfloat factor = a.at(j).at(i);
+            for (size_t k = 0; k < n; ++k) {
+                a.at(j).at(k) -= factor * a.at(i).at(k);
+                inv.at(j).at(k) -= factor * inv.at(i).at(k);
+            }
+        }
+    }
+    return inv;
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<int> entry(-9, 9);
+    bool agree = true;
+    std::cout << "MatrixBF solve_gauss (DIVISION) and inverse, ms per call\n"
+              << std::setw(6) << "n" << std::setw(14) << "solve nested" << std::setw(14)
+              << "solve flat" << std::setw(14) << "inv nested" << std::setw(14) << "inv flat"
+              << std::setw(8) << "result" << "\n";
+    for (const size_t n : {25, 50, 100, 200}) {
+        Nested rows(n, std::vector<bigfloat>(n));
+        std::vector<bigfloat> b(n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) rows[i][j] = bigfloat(entry(rng));
+            b[i] = bigfloat(entry(rng));
+        }
+        const MatrixBF a(rows);
+
+        std::vector<bigfloat> x_nested, x_flat;
+        Nested inv_nested;
+        MatrixBF inv_flat;
+        const double solve_nested =
+            milliseconds_per_call([&] { x_nested = nested_solve_gauss(rows, b); });
+        const double solve_flat = milliseconds_per_call(
+            [&] { x_flat = a.solve_gauss(b, Elimination::DIVISION); });
+        const double inverse_nested =
+            milliseconds_per_call([&] { inv_nested = nested_inverse(rows); });
+        const double inverse_flat = milliseconds_per_call([&] { inv_flat = a.inverse(); });
+
+        const bool same = x_nested == x_flat && inv_flat == MatrixBF(inv_nested);
+        agree = agree && same;
+        std::cout << std::setw(6) << n << std::fixed << std::setprecision(2) << std::setw(14)
+                  << solve_nested << std::setw(14) << solve_flat << std::setw(14)
+                  << inverse_nested << std::setw(14) << inverse_flat << std::setw(8)
+                  << (same ? "same" : "DIFFER") << "\n";
+    }
+    return agree ? EXIT_SUCCESS : EXIT_FAILURE;
+}
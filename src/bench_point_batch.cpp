@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "simd_kernels.h"
+#include "vector.hpp"
+
+// PointBatch kernels against the single-point predicates: the on-segment
+// answers must agree exactly, distances and angles to rounding, and the
+// timings are printed for 1M points in 2, 3 and 5 dimensions.
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Points spread over [-range, range]; every third one is a + t (b - a) for a
+// random t in [-0.25, 1.25], so it sits on the segment's line up to rounding.
+std::vector<Vector> make_points(size_t count, size_t dimension, double range,
+                                const Vector &a, const Vector &b, std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> coordinate(-range, range);
+    std::uniform_real_distribution<double> parameter(-0.25, 1.25);
+    std::vector<Vector> points;
+    points.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        Vector point(dimension);
+        if (i % 3 == 0) {
+            const double t = parameter(rng);
+            for (size_t k = 0; k < dimension; ++k) point[k] = a[k] + t * (b[k] - a[k]);
+        } else {
+            for (size_t k = 0; k < dimension; ++k) point[k] = coordinate(rng);
+        }
+        points.push_back(point);
+    }
+    return points;
+}
+
+Vector random_vector(size_t dimension, double range, std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> coordinate(-range, range);
+    Vector result(dimension);
+    for (size_t k = 0; k < dimension; ++k) result[k] = coordinate(rng);
+    return result;
+}
+
+// Number of points where the batch and single-point on-segment answers
+// differ, for segments and points spread over `range`.
+size_t on_segment_mismatches(size_t dimension, double range, std::mt19937_64 &rng) {
+    constexpr size_t kSegments = 100;
+    constexpr size_t kPoints = 384;
+    size_t mismatches = 0;
+    for (size_t s = 0; s < kSegments; ++s) {
+        const Vector a = random_vector(dimension, range, rng);
+        const Vector b = random_vector(dimension, range, rng);
+        const std::vector<Vector> points = make_points(kPoints, dimension, range, a, b, rng);
+        const PointBatch batch(points);
+        const std::unique_ptr<bool[]> on(new bool[kPoints]);
+        is_point_on_segment(batch, a, b, on.get());
+        for (size_t i = 0; i < kPoints; ++i) {
+            if (on[i] != is_point_on_segment(points[i], a, b)) ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+void time_kernels(size_t dimension, std::mt19937_64 &rng) {
+    constexpr size_t kPoints = 1'000'000;
+    const Vector a = random_vector(dimension, 10.0, rng);
+    const Vector b = random_vector(dimension, 10.0, rng);
+    const std::vector<Vector> points = make_points(kPoints, dimension, 10.0, a, b, rng);
+    const PointBatch batch(points);
+    std::vector<double> batch_values(kPoints), single_values(kPoints);
+    const std::unique_ptr<bool[]> batch_on(new bool[kPoints]);
+    const std::unique_ptr<bool[]> single_on(new bool[kPoints]);
+
+    auto start = Clock::now();
+    point_to_segment_distance(batch, a, b, batch_values.data());
+    const double distance_batch = milliseconds_since(start);
+    start = Clock::now();
+    for (size_t i = 0; i < kPoints; ++i)
+        single_values[i] = point_to_segment_distance(points[i], a, b);
+    const double distance_single = milliseconds_since(start);
+    double distance_error = 0.0;
+    for (size_t i = 0; i < kPoints; ++i)
+        distance_error = std::max(distance_error, std::fabs(batch_values[i] - single_values[i]));
+
+    start = Clock::now();
+    is_point_on_segment(batch, a, b, batch_on.get());
+    const double on_batch = milliseconds_since(start);
+    start = Clock::now();
+    for (size_t i = 0; i < kPoints; ++i) single_on[i] = is_point_on_segment(points[i], a, b);
+    const double on_single = milliseconds_since(start);
+    size_t on_mismatches = 0;
+    for (size_t i = 0; i < kPoints; ++i) on_mismatches += batch_on[i] != single_on[i];
+
+    start = Clock::now();
+    angle_between(batch, a, batch_values.data());
+    const double angle_batch = milliseconds_since(start);
+    start = Clock::now();
+    for (size_t i = 0; i < kPoints; ++i) {
+        try {
+            single_values[i] = angle_between(points[i], a);
+        } catch (const std::domain_error &) {
+            single_values[i] = std::nan("");
+        }
+    }
+    const double angle_single = milliseconds_since(start);
+    double angle_error = 0.0;
+    for (size_t i = 0; i < kPoints; ++i) {
+        if (!std::isnan(batch_values[i]) || !std::isnan(single_values[i]))
+            angle_error = std::max(angle_error, std::fabs(batch_values[i] - single_values[i]));
+    }
+
+    std::cout << "d = " << dimension << ", " << kPoints << " points ("
+              << simd_isa() << " build)\n"
+              << std::fixed << std::setprecision(1)
+              << "  distance:   batch " << distance_batch << " ms, single " << distance_single
+              << " ms, max difference " << std::scientific << distance_error << "\n"
+              << std::fixed
+              << "  on-segment: batch " << on_batch << " ms, single " << on_single
+              << " ms, mismatches " << on_mismatches << "\n"
+              << "  angle:      batch " << angle_batch << " ms, single " << angle_single
+              << " ms, max difference " << std::scientific << angle_error << "\n"
+              << std::fixed;
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    bool identical = true;
+    std::cout << "on-segment batch vs single-point mismatches:\n";
+    for (const size_t dimension : {2, 3, 5}) {
+        for (const double range : {1.0, 1e2, 1e4, 1e7}) {
+            const size_t mismatches = on_segment_mismatches(dimension, range, rng);
+            identical = identical && mismatches == 0;
+            std::cout << "  d = " << dimension << ", range " << std::scientific
+                      << std::setprecision(0) << range << ": " << mismatches << "\n";
+        }
+    }
+    std::cout << "\n";
+    for (const size_t dimension : {2, 3, 5}) time_kernels(dimension, rng);
+    return identical ? EXIT_SUCCESS : EXIT_FAILURE;
+}
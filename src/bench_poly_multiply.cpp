@@ -0,0 +1,207 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "polynomial.hpp"
+#include "power_series.hpp"
+
+// Degree sweep for the PowerSeries (double) and Polynomial (bigfloat)
+// products: the schoolbook product, Karatsuba alone, Karatsuba with Toom-3,
+// and the default multiply() with the transform path, forced through the
+// PolyMultiplier crossover setters. Before the sweep, the double transform
+// path is checked on products with a wide dynamic range.
+
+constexpr size_t kNever = std::numeric_limits<size_t>::max();
+
+// Schoolbook products of bigfloat coefficients above this length take
+// minutes and are skipped.
+constexpr size_t kLongestBigfloatSchoolbook = 2048;
+
+double milliseconds_per_call(const std::function<void()> &call) {
+    using Clock = std::chrono::steady_clock;
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    do {
+        call();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 100.0);
+    return elapsed.count() / static_cast<double>(calls);
+}
+
+// Crossovers for one column of the sweep; 0 keeps the default.
+struct Strategy {
+    const char *name;
+    size_t karatsuba;
+    size_t toom3;
+    size_t transform;
+};
+
+const Strategy kStrategies[] = {
+    {"schoolbook", kNever, kNever, kNever},
+    {"karatsuba", 0, kNever, kNever},
+    {"+toom-3", 0, 0, kNever},
+    {"default", 0, 0, 0},
+};
+
+template <typename T>
+void use(const Strategy &strategy) {
+    PolyMultiplier<T>::set_karatsuba_crossover(strategy.karatsuba);
+    PolyMultiplier<T>::set_toom3_crossover(strategy.toom3);
+    PolyMultiplier<T>::set_transform_crossover(strategy.transform);
+}
+
+void print_header(const char *title) {
+    std::cout << title << " (ms per product)\n" << std::setw(8) << "length";
+    for (const Strategy &strategy : kStrategies) std::cout << std::setw(14) << strategy.name;
+    std::cout << std::setw(16) << "max difference" << "\n";
+}
+
+void sweep_power_series(std::mt19937_64 &rng) {
+    print_header("PowerSeries");
+    std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+    for (size_t n = 16; n <= 8192; n *= 2) {
+        std::vector<double> f(n), g(n);
+        for (size_t i = 0; i < n; ++i) {
+            f[i] = coefficient(rng);
+            g[i] = coefficient(rng);
+        }
+        const PowerSeries a(f), b(g);
+
+        std::cout << std::setw(8) << n << std::fixed << std::setprecision(3);
+        PowerSeries reference;
+        double difference = 0.0;
+        for (const Strategy &strategy : kStrategies) {
+            use<double>(strategy);
+            PowerSeries product;
+            std::cout << std::setw(14) << milliseconds_per_call([&] { product = a * b; });
+            if (strategy.karatsuba == kNever) {
+                reference = product;
+            } else {
+                for (size_t i = 0; i < product.size(); ++i)
+                    difference = std::max(difference, std::fabs(product[i] - reference[i]));
+            }
+        }
+        std::cout << std::setw(16) << std::scientific << std::setprecision(2) << difference
+                  << "\n";
+    }
+    use<double>({"", 0, 0, 0});
+    std::cout << "\n";
+}
+
+void sweep_polynomial(std::mt19937_64 &rng) {
+    print_header("Polynomial");
+    std::uniform_int_distribution<int> numerator(-1000, 1000);
+    for (size_t n = 16; n <= 8192; n *= 2) {
+        std::vector<bigfloat> f(n), g(n);
+        for (size_t i = 0; i < n; ++i) {
+            f[i] = bigfloat(numerator(rng)) / bigfloat(7);
+            g[i] = bigfloat(numerator(rng)) / bigfloat(7);
+        }
+        const Polynomial a{VectorBF(f)}, b{VectorBF(g)};
+
+        std::cout << std::setw(8) << n << std::fixed << std::setprecision(3);
+        for (const Strategy &strategy : kStrategies) {
+            if (strategy.karatsuba == kNever && n > kLongestBigfloatSchoolbook) {
+                std::cout << std::setw(14) << "-";
+                continue;
+            }
+            use<bigfloat>(strategy);
+            std::cout << std::setw(14) << milliseconds_per_call([&] { (void)(a * b); });
+        }
+        std::cout << std::setw(16) << "-" << "\n";
+    }
+    use<bigfloat>({"", 0, 0, 0});
+    std::cout << "\n";
+}
+
+// Largest error of the transform product relative to the matching
+// coefficient of |a| * |b|, with the schoolbook product as reference; -1
+// when the transform declines and multiply() falls back.
+double transform_error(const std::vector<double> &f, const std::vector<double> &g) {
+    const std::optional<std::vector<double>> product = PolyTransform<double>::multiply(f, g);
+    if (!product) return -1.0;
+
+    std::vector<double> f_magnitude(f.size()), g_magnitude(g.size());
+    for (size_t i = 0; i < f.size(); ++i) f_magnitude[i] = std::fabs(f[i]);
+    for (size_t i = 0; i < g.size(); ++i) g_magnitude[i] = std::fabs(g[i]);
+    use<double>(kStrategies[0]);
+    const PowerSeries reference = PowerSeries(f) * PowerSeries(g);
+    const PowerSeries magnitude = PowerSeries(f_magnitude) * PowerSeries(g_magnitude);
+    use<double>({"", 0, 0, 0});
+
+    double error = 0.0;
+    for (size_t i = 0; i < product->size(); ++i) {
+        const double difference = std::fabs((*product)[i] - reference[i]);
+        if (difference > 0.0) error = std::max(error, difference / magnitude[i]);
+    }
+    return error;
+}
+
+// The transform product must stay within 1e-10 of every coefficient of
+// |a| * |b| whenever it is accepted, however wide the range of the
+// coefficients.
+bool check_dynamic_range(std::mt19937_64 &rng) {
+    std::uniform_real_distribution<double> coefficient(-1.0, 1.0);
+    std::cout << "transform error relative to |a| * |b|:\n";
+    bool accurate = true;
+    const auto report = [&](const char *label, double error) {
+        accurate = accurate && error <= 1e-10;
+        std::cout << "  " << label;
+        if (error < 0.0) {
+            std::cout << "declined\n";
+        } else {
+            std::cout << std::scientific << std::setprecision(2) << error << "\n";
+        }
+    };
+
+    // One huge coefficient over many tiny ones: the FFT error from the huge
+    // one swamps the upper half of the product.
+    std::vector<double> f(2000, 1e-20), g(2000, 1.0);
+    f[0] = 1e20;
+    report("1e20 and 1999 x 1e-20 by 2000 x 1:  ", transform_error(f, g));
+
+    // Coefficients decaying geometrically over 18 orders of magnitude.
+    f.assign(4096, 0.0);
+    g.assign(4096, 0.0);
+    for (size_t i = 0; i < f.size(); ++i) {
+        const double scale = std::pow(0.99, static_cast<double>(i));
+        f[i] = scale * coefficient(rng);
+        g[i] = scale * coefficient(rng);
+    }
+    report("decaying as 0.99^i, length 4096:    ", transform_error(f, g));
+
+    // Uniform coefficients, where only the few smallest products at either
+    // end fall outside the bound.
+    for (size_t i = 0; i < f.size(); ++i) {
+        f[i] = coefficient(rng);
+        g[i] = coefficient(rng);
+    }
+    report("uniform in [-1, 1], length 4096:    ", transform_error(f, g));
+    std::cout << "\n";
+    return accurate;
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    const bool accurate = check_dynamic_range(rng);
+    std::cout << "crossovers (double): karatsuba " << PolyMultiplier<double>::karatsuba_crossover()
+              << ", toom-3 " << PolyMultiplier<double>::toom3_crossover() << ", transform "
+              << PolyMultiplier<double>::transform_crossover() << "\n"
+              << "crossovers (bigfloat): karatsuba "
+              << PolyMultiplier<bigfloat>::karatsuba_crossover() << ", toom-3 "
+              << PolyMultiplier<bigfloat>::toom3_crossover() << ", transform "
+              << PolyMultiplier<bigfloat>::transform_crossover() << "\n\n";
+    sweep_power_series(rng);
+    sweep_polynomial(rng);
+    return accurate ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+
+#include "MatrixBF.h"
+
+// MatrixBF products through the classical blocked kernel and through
+// Strassen-Winograd with several crossovers: bigfloat multiplications
+// performed and wall time. Entries are sevenths, so the products stay off
+// the multi-modular engine that takes integer matrices.
+
+constexpr size_t kNever = std::numeric_limits<size_t>::max();
+
+double milliseconds_per_call(const std::function<void()> &call) {
+    using Clock = std::chrono::steady_clock;
+    size_t calls = 0;
+    const auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed{};
+    do {
+        call();
+        ++calls;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < 200.0);
+    return elapsed.count() / static_cast<double>(calls);
+}
+
+// Multiplications in an m x k by k x n product, split the way
+// multiply_strassen splits it: 7 half-size products per level, odd sizes
+// rounded up, classical below the crossover. Zero padding counts as if it
+// were multiplied, so this is an upper bound.
+double multiplications(size_t m, size_t k, size_t n, size_t crossover) {
+    if (std::min({m, k, n}) < std::max<size_t>(crossover, 2))
+        return static_cast<double>(m) * static_cast<double>(k) * static_cast<double>(n);
+    return 7.0 * multiplications((m + 1) / 2, (k + 1) / 2, (n + 1) / 2, crossover);
+}
+
+int main() {
+    std::mt19937_64 rng(2024);
+    std::uniform_int_distribution<int> numerator(-999, 999);
+    bool exact = true;
+    std::cout << "tuned Strassen crossover: " << MatrixBF::strassen_crossover() << "\n\n";
+    for (const size_t n : {64, 128, 256}) {
+        MatrixBF a(n, n), b(n, n);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                a(i, j) = bigfloat(numerator(rng)) / bigfloat(7);
+                b(i, j) = bigfloat(numerator(rng)) / bigfloat(7);
+            }
+        }
+        std::cout << "n = " << n << "\n"
+                  << std::setw(12) << "crossover" << std::setw(16) << "multiplications"
+                  << std::setw(10) << "saved" << std::setw(12) << "ms" << std::setw(8)
+                  << "result" << "\n";
+
+        MatrixBF::set_strassen_crossover(kNever);
+        MatrixBF reference;
+        const double classical_ms = milliseconds_per_call([&] { reference = a * b; });
+        const double classical = multiplications(n, n, n, kNever);
+        std::cout << std::setw(12) << "classical" << std::setw(16) << std::fixed
+                  << std::setprecision(0) << classical << std::setw(10) << "-" << std::setw(12)
+                  << std::setprecision(2) << classical_ms << std::setw(8) << "-" << "\n";
+
+        for (const size_t crossover : {16, 32, 64}) {
+            if (crossover > n) continue;
+            MatrixBF::set_strassen_crossover(crossover);
+            MatrixBF product;
+            const double ms = milliseconds_per_call([&] { product = a * b; });
+            const double count = multiplications(n, n, n, crossover);
+            const bool same = product == reference;
+            exact = exact && same;
+            std::cout << std::setw(12) << crossover << std::setw(16) << std::setprecision(0)
+                      << count << std::setw(9) << std::setprecision(1)
+                      << 100.0 * (1.0 - count / classical) << "%" << std::setw(12)
+                      << std::setprecision(2) << ms << std::setw(8) << (same ? "same" : "DIFFER")
+                      << "\n";
+        }
+        std::cout << "\n";
+    }
+    MatrixBF::set_strassen_crossover(0);
+    return exact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
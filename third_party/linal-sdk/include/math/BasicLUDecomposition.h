@@ -0,0 +1,339 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BasicMatrix.h"
+#include "parallel_for.h"
+#include "scalar_traits.h"
+#include "simd_kernels.h"
+
+// PA = LU with partial pivoting, computed once and reused for any number of
+// right-hand sides. L (unit diagonal, not stored) and U are packed into one
+// matrix whose rows are already in pivot order. LUDecomposition and
+// LUDecompositionBF are the double and bigfloat instances.
+//
+// The factorization is right-looking and blocked: each panel of kBlock
+// columns is factored on its own, then the trailing matrix receives one
+// rank-kBlock update split into independent row tiles, which run as
+// parallel_for tasks when scalar_traits<T>::parallel_kernels allows and the
+// update reaches kParallelMinimumWork multiply-adds. For
+// Matrix that update is a packed SIMD product per tile. Solves with many
+// right-hand sides are split into column tiles the same way.
+template <typename T>
+class BasicLUDecomposition {
+ private:
+  using traits = scalar_traits<T>;
+
+  static constexpr size_t kBlock = 64;
+  static constexpr size_t kTile = 64;
+
+  BasicMatrix<T> lu_;
+  std::vector<size_t> perm_;
+  bool singular_{};
+  bool odd_permutation_{};
+
+  void check_rhs(size_t size, const std::string& op) const {
+    if (size != lu_.rows()) {
+      throw std::runtime_error("Matrix size mismatch in operation: " + op);
+    }
+  }
+  void check_nonsingular(const std::string& op) const {
+    if (singular_) {
+      throw std::runtime_error("No unique solution in operation: " + op);
+    }
+  }
+
+  void factor_panel(size_t begin, size_t end);
+  void update_trailing(size_t begin, size_t end);
+
+ public:
+  BasicLUDecomposition() = default;
+  explicit BasicLUDecomposition(const BasicMatrix<T>& matrix);
+
+  size_t size() const noexcept { return lu_.rows(); }
+  bool is_singular() const noexcept { return singular_; }
+
+  const BasicMatrix<T>& packed() const noexcept { return lu_; }
+  // Row i of PA is row permutation()[i] of A.
+  const std::vector<size_t>& permutation() const noexcept { return perm_; }
+
+  // min |u_ii| / max |u_ii|: a cheap indicator, tiny values flag
+  // ill-conditioning. Zero for singular matrices.
+  T pivot_ratio() const;
+
+  std::vector<T> solve(const std::vector<T>& b) const;
+  std::vector<std::vector<T>> solve(
+      const std::vector<std::vector<T>>& rhs) const;
+  // Solves AX = B for every column of B at once.
+  BasicMatrix<T> solve(const BasicMatrix<T>& rhs) const;
+
+  T determinant() const;
+  BasicMatrix<T> inverse() const;
+};
+
+template <typename T>
+BasicLUDecomposition<T>::BasicLUDecomposition(const BasicMatrix<T>& matrix)
+    : lu_(matrix) {
+  if (matrix.rows() != matrix.cols()) {
+    throw std::runtime_error("Matrix must be square for operation: lu");
+  }
+  const size_t n = matrix.rows();
+  perm_.resize(n);
+  std::iota(perm_.begin(), perm_.end(), 0);
+
+  for (size_t begin = 0; begin < n; begin += kBlock) {
+    const size_t end = std::min(begin + kBlock, n);
+    factor_panel(begin, end);
+    if (end < n) {
+      update_trailing(begin, end);
+    }
+  }
+}
+
+// Unblocked elimination restricted to columns [begin, end). Pivot rows are
+// swapped across the full width, so the packed rows stay in pivot order.
+template <typename T>
+void BasicLUDecomposition<T>::factor_panel(size_t begin, size_t end) {
+  const size_t n = size();
+  for (size_t i = begin; i < end; ++i) {
+    size_t sel = i;
+    T best = traits::abs(lu_(i, i));
+    for (size_t j = i + 1; j < n; ++j) {
+      T candidate = traits::abs(lu_(j, i));
+      if (candidate > best) {
+        best = std::move(candidate);
+        sel = j;
+      }
+    }
+
+    if (best == T(0)) {
+      singular_ = true;
+      continue;
+    }
+
+    if (sel != i) {
+      lu_.swap_rows(i, sel);
+      std::swap(perm_[i], perm_[sel]);
+      odd_permutation_ = !odd_permutation_;
+    }
+
+    const T* pivot_row = lu_.row_data(i);
+    for (size_t j = i + 1; j < n; ++j) {
+      T* row = lu_.row_data(j);
+      if (row[i] == T(0)) {
+        continue;
+      }
+      row[i] /= pivot_row[i];
+      subtract_scaled(row + i + 1, pivot_row + i + 1, row[i], end - i - 1);
+    }
+  }
+}
+
+// U12 = L11^-1 A12, then A22 -= L21 U12 one tile of rows per task.
+template <typename T>
+void BasicLUDecomposition<T>::update_trailing(size_t begin, size_t end) {
+  const size_t n = size();
+  const size_t width = n - end;
+
+  for (size_t i = begin + 1; i < end; ++i) {
+    T* row = lu_.row_data(i);
+    for (size_t j = begin; j < i; ++j) {
+      if (row[j] != T(0)) {
+        subtract_scaled(row + end, lu_.row_data(j) + end, row[j], width);
+      }
+    }
+  }
+
+  BasicMatrix<T> u12;
+  if constexpr (traits::simd_kernels) {
+    u12 = BasicMatrix<T>(end - begin, width);
+    for (size_t i = begin; i < end; ++i) {
+      std::copy(lu_.row_data(i) + end, lu_.row_data(i) + n,
+                u12.row_data(i - begin));
+    }
+  }
+
+  const size_t tiles = (width + kTile - 1) / kTile;
+  const bool parallel = traits::parallel_kernels &&
+                        width * width * (end - begin) >= kParallelMinimumWork;
+  parallel_for_if(parallel, 0, tiles, [&](size_t tile) {
+    const size_t first = end + tile * kTile;
+    const size_t last = std::min(first + kTile, n);
+    if constexpr (traits::simd_kernels) {
+      BasicMatrix<T> product(last - first, end - begin);
+      for (size_t i = first; i < last; ++i) {
+        std::copy(lu_.row_data(i) + begin, lu_.row_data(i) + end,
+                  product.row_data(i - first));
+      }
+      product *= u12;
+      for (size_t i = first; i < last; ++i) {
+        subtract_scaled(lu_.row_data(i) + end, product.row_data(i - first),
+                        T(1), width);
+      }
+    } else {
+      for (size_t i = first; i < last; ++i) {
+        T* row = lu_.row_data(i);
+        for (size_t j = begin; j < end; ++j) {
+          if (row[j] != T(0)) {
+            subtract_scaled(row + end, lu_.row_data(j) + end, row[j], width);
+          }
+        }
+      }
+    }
+  });
+}
+
+template <typename T>
+T BasicLUDecomposition<T>::pivot_ratio() const {
+  const size_t n = size();
+  if (n == 0) {
+    return T(1);
+  }
+  T lo = traits::abs(lu_(0, 0));
+  T hi = lo;
+  for (size_t i = 1; i < n; ++i) {
+    T u = traits::abs(lu_(i, i));
+    if (u < lo) {
+      lo = u;
+    }
+    if (u > hi) {
+      hi = std::move(u);
+    }
+  }
+  return hi == T(0) ? T(0) : lo / hi;
+}
+
+template <typename T>
+std::vector<T> BasicLUDecomposition<T>::solve(const std::vector<T>& b) const {
+  check_rhs(b.size(), "solve");
+  check_nonsingular("solve");
+  const size_t n = size();
+
+  std::vector<T> x(n);
+  for (size_t i = 0; i < n; ++i) {
+    const T* row = lu_.row_data(i);
+    T sum = b[perm_[i]];
+    for (size_t k = 0; k < i; ++k) {
+      if (row[k] != T(0)) {
+        sum -= row[k] * x[k];
+      }
+    }
+    x[i] = std::move(sum);
+  }
+
+  for (size_t i = n; i-- > 0;) {
+    const T* row = lu_.row_data(i);
+    T sum = std::move(x[i]);
+    for (size_t k = i + 1; k < n; ++k) {
+      if (row[k] != T(0)) {
+        sum -= row[k] * x[k];
+      }
+    }
+    x[i] = sum / row[i];
+  }
+
+  return x;
+}
+
+template <typename T>
+std::vector<std::vector<T>> BasicLUDecomposition<T>::solve(
+    const std::vector<std::vector<T>>& rhs) const {
+  const size_t n = size();
+  BasicMatrix<T> b(n, rhs.size());
+  for (size_t j = 0; j < rhs.size(); ++j) {
+    check_rhs(rhs[j].size(), "solve");
+    for (size_t i = 0; i < n; ++i) {
+      b(i, j) = rhs[j][i];
+    }
+  }
+
+  BasicMatrix<T> x = solve(b);
+
+  std::vector<std::vector<T>> result(rhs.size(), std::vector<T>(n));
+  for (size_t j = 0; j < rhs.size(); ++j) {
+    for (size_t i = 0; i < n; ++i) {
+      result[j][i] = std::move(x(i, j));
+    }
+  }
+  return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicLUDecomposition<T>::solve(const BasicMatrix<T>& rhs) const {
+  check_rhs(rhs.rows(), "solve");
+  check_nonsingular("solve");
+  const size_t n = size();
+  const size_t m = rhs.cols();
+
+  // Rows of the right-hand side are updated a tile of columns at a time so
+  // the inner loops stay contiguous; tiles are independent tasks.
+  BasicMatrix<T> x(n, m);
+  for (size_t i = 0; i < n; ++i) {
+    std::copy(rhs.row_data(perm_[i]), rhs.row_data(perm_[i]) + m,
+              x.row_data(i));
+  }
+
+  const size_t tiles = (m + kTile - 1) / kTile;
+  const bool parallel =
+      traits::parallel_kernels && n * n * m >= kParallelMinimumWork;
+  parallel_for_if(parallel, 0, tiles, [&](size_t tile) {
+    const size_t first = tile * kTile;
+    const size_t width = std::min(kTile, m - first);
+
+    for (size_t i = 0; i < n; ++i) {
+      const T* row = lu_.row_data(i);
+      T* target = x.row_data(i) + first;
+      for (size_t k = 0; k < i; ++k) {
+        if (row[k] != T(0)) {
+          subtract_scaled(target, x.row_data(k) + first, row[k], width);
+        }
+      }
+    }
+
+    for (size_t i = n; i-- > 0;) {
+      const T* row = lu_.row_data(i);
+      T* target = x.row_data(i) + first;
+      for (size_t k = i + 1; k < n; ++k) {
+        if (row[k] != T(0)) {
+          subtract_scaled(target, x.row_data(k) + first, row[k], width);
+        }
+      }
+      for (size_t j = 0; j < width; ++j) {
+        target[j] /= row[i];
+      }
+    }
+  });
+
+  return x;
+}
+
+template <typename T>
+T BasicLUDecomposition<T>::determinant() const {
+  if (singular_) {
+    return T(0);
+  }
+  T det(1);
+  for (size_t i = 0; i < size(); ++i) {
+    det *= lu_(i, i);
+  }
+  return odd_permutation_ ? -det : det;
+}
+
+template <typename T>
+BasicMatrix<T> BasicLUDecomposition<T>::inverse() const {
+  if (singular_) {
+    throw std::runtime_error("Singular matrix");
+  }
+  const size_t n = size();
+  BasicMatrix<T> identity(n, n);
+  for (size_t i = 0; i < n; ++i) {
+    identity(i, i) = T(1);
+  }
+  return solve(identity);
+}
+
+extern template class BasicLUDecomposition<bigfloat>;
@@ -0,0 +1,1746 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BasicVector.h"
+#include "aligned_allocator.h"
+#include "expression_templates.h"
+#include "parallel_for.h"
+#include "scalar_traits.h"
+#include "simd_kernels.h"
+
+template <typename T>
+class BasicLUDecomposition;
+template <typename T>
+class BasicSparseMatrix;
+template <typename T>
+class BasicSparseLU;
+
+// How determinant(), rank() and solve_gauss() eliminate.
+enum class Elimination {
+  // solve_gauss() and determinant() first use the cheaper solver for the
+  // matrix's structure, see MatrixStructure. Otherwise FRACTION_FREE when
+  // the scalar is exact and every entry is an integer, DIVISION otherwise.
+  AUTO,
+  // Classic Gaussian elimination, one division per updated entry.
+  DIVISION,
+  // Bareiss elimination: entries stay integers (for integer input) and each
+  // update does a single exact division by the previous pivot.
+  FRACTION_FREE,
+  // Opt-in multi-modular engine (see modular_linalg.h) for integer
+  // bigfloat matrices; anything else falls back to AUTO.
+  MODULAR,
+};
+
+// The shape analyze() detects from the exact zero pattern, which doubles as
+// the solver solve_gauss() picks for it in AUTO mode.
+enum class MatrixStructure {
+  // O(n): one division per unknown.
+  DIAGONAL,
+  // O(n^2) forward or back substitution.
+  LOWER_TRIANGULAR,
+  UPPER_TRIANGULAR,
+  // Band elimination with partial pivoting inside the band,
+  // O(n * p * (p + q)) for lower bandwidth p and upper bandwidth q.
+  TRIDIAGONAL,
+  BANDED,
+  // LDL^T without pivoting, about half the work of LU. Rounded scalars take
+  // it only while every pivot is positive, i.e. for positive definite
+  // matrices; integer matrices over exact scalars stay with Bareiss.
+  SYMMETRIC,
+  // Dense elimination.
+  GENERAL,
+};
+
+struct MatrixAnalysis {
+  MatrixStructure structure = MatrixStructure::GENERAL;
+  // Largest i - j and j - i over the nonzero entries (i, j).
+  size_t lower_bandwidth = 0;
+  size_t upper_bandwidth = 0;
+  bool symmetric = false;
+};
+
+// Eigenvalue re + im i. std::complex is only specified for the built-in
+// floating-point types, so it cannot carry a bigfloat.
+template <typename T>
+struct Eigenvalue {
+  T re;
+  T im;
+};
+
+// Non-owning view over every `stride`-th element starting at `data`.
+// Rows of a row-major matrix have stride 1, columns have stride cols().
+template <typename T>
+class StridedSpan {
+ private:
+  T* data_;
+  size_t size_;
+  size_t stride_;
+
+ public:
+  StridedSpan(T* data, size_t size, size_t stride) noexcept
+      : data_(data), size_(size), stride_(stride) {}
+
+  size_t size() const noexcept { return size_; }
+  size_t stride() const noexcept { return stride_; }
+  T* data() const noexcept { return data_; }
+
+  T& operator[](size_t index) const noexcept {
+    return data_[index * stride_];
+  }
+};
+
+// Dense row-major matrix over any scalar with a scalar_traits
+// specialization. Matrix and MatrixBF are BasicMatrix<double> and
+// BasicMatrix<bigfloat>; the traits pick the pivoting strategy, the default
+// tolerances and which multiplication kernels apply. Sums, differences and
+// scalar multiples are lazy, see expression_templates.h.
+template <typename T>
+class BasicMatrix : public MatrixExpression<BasicMatrix<T>, T> {
+ private:
+  using traits = scalar_traits<T>;
+
+  // Row-major, element (i, j) lives at data_[i * cols_ + j]. The buffer is
+  // cache-line aligned for the vector kernels.
+  std::vector<T, AlignedAllocator<T>> data_;
+  size_t rows_{}, cols_{};
+
+  void check_square(const std::string& op) const {
+    if (rows_ != cols_) {
+      throw std::runtime_error("Matrix must be square for operation: " + op);
+    }
+  }
+
+  static size_t select_pivot(const BasicMatrix& a,
+                             const std::vector<size_t>& perm, size_t from,
+                             size_t col);
+
+  T determinant_bareiss() const;
+  size_t rank_bareiss() const;
+  std::vector<T> solve_bareiss(std::vector<T> const& b) const;
+  bool use_fraction_free(Elimination mode) const;
+
+  // Structure-specific solvers behind solve_gauss(); std::nullopt when the
+  // matrix is GENERAL or LDL^T breaks down.
+  std::optional<std::vector<T>> try_structured_solve(
+      std::vector<T> const& b, MatrixStructure* solver) const;
+  std::vector<T> solve_diagonal(std::vector<T> const& b) const;
+  std::vector<T> solve_triangular(std::vector<T> const& b, bool lower) const;
+  std::vector<T> solve_banded(std::vector<T> const& b, size_t lower,
+                              size_t upper) const;
+  std::optional<std::vector<T>> solve_ldlt(std::vector<T> const& b) const;
+
+  // The multi-modular engine, std::nullopt when it does not apply. Only
+  // BasicMatrix<bigfloat> has one, see MatrixBF.cpp.
+  std::optional<T> try_modular_determinant() const { return std::nullopt; }
+  std::optional<size_t> try_modular_rank() const { return std::nullopt; }
+  std::optional<std::vector<T>> try_modular_solve(
+      std::vector<T> const& /*b*/) const {
+    return std::nullopt;
+  }
+  std::optional<BasicMatrix> try_modular_multiply(
+      BasicMatrix const& /*rhs*/) const {
+    return std::nullopt;
+  }
+
+  static BasicMatrix multiply_blocked(const BasicMatrix& lhs,
+                                      const BasicMatrix& rhs);
+  static BasicMatrix multiply_strassen(const BasicMatrix& lhs,
+                                       const BasicMatrix& rhs,
+                                       size_t crossover);
+  static BasicMatrix block_of(const BasicMatrix& source, size_t row,
+                              size_t col, size_t rows, size_t cols);
+  static void place_block(BasicMatrix& target, BasicMatrix&& block,
+                          size_t row, size_t col);
+  static std::atomic<size_t>& strassen_crossover_override();
+
+  // Products with every dimension at least this large try the multi-modular
+  // engine first; below it, reading the entries as integers and rebuilding
+  // the result costs about as much as the bigfloat product.
+  static constexpr size_t kModularMultiplySmallest = 16;
+  static constexpr size_t kStrassenSmallestCandidate = 16;
+  static constexpr size_t kStrassenLargestCandidate = 128;
+  static constexpr size_t kEigenGuardDigits = 10;
+
+ public:
+  using value_type = T;
+
+  BasicMatrix() = default;
+  BasicMatrix(size_t rows, size_t cols)
+      : data_(rows * cols, T(0)), rows_(rows), cols_(cols) {}
+  BasicMatrix(std::vector<std::vector<T>> const& data);
+
+  // Evaluates an expression in a single pass.
+  template <typename E>
+  BasicMatrix(const MatrixExpression<E, T>& expression);
+  template <typename E>
+  BasicMatrix& operator=(const MatrixExpression<E, T>& expression);
+
+  size_t rows() const noexcept { return rows_; }
+  size_t cols() const noexcept { return cols_; }
+  T& at(size_t row, size_t col);
+  const T& at(size_t row, size_t col) const;
+
+  // Unchecked access for inner loops.
+  T& operator()(size_t row, size_t col) noexcept {
+    return data_[row * cols_ + col];
+  }
+  const T& operator()(size_t row, size_t col) const noexcept {
+    return data_[row * cols_ + col];
+  }
+  T* row_data(size_t row) noexcept { return data_.data() + row * cols_; }
+  const T* row_data(size_t row) const noexcept {
+    return data_.data() + row * cols_;
+  }
+
+  StridedSpan<T> row(size_t row) { return {row_data(row), cols_, 1}; }
+  StridedSpan<const T> row(size_t row) const {
+    return {row_data(row), cols_, 1};
+  }
+  StridedSpan<T> col(size_t col) { return {data_.data() + col, rows_, cols_}; }
+  StridedSpan<const T> col(size_t col) const {
+    return {data_.data() + col, rows_, cols_};
+  }
+  StridedSpan<T> diagonal() {
+    return {data_.data(), std::min(rows_, cols_), cols_ + 1};
+  }
+  StridedSpan<const T> diagonal() const {
+    return {data_.data(), std::min(rows_, cols_), cols_ + 1};
+  }
+
+  void swap_rows(size_t first, size_t second);
+
+  template <typename E>
+  BasicMatrix& operator+=(const MatrixExpression<E, T>& other);
+  template <typename E>
+  BasicMatrix& operator-=(const MatrixExpression<E, T>& other);
+  BasicMatrix& operator*=(const T& scalar);
+  BasicMatrix& operator*=(const BasicMatrix& other);
+
+  // y = A x, the same entry point BasicSparseMatrix offers.
+  std::vector<T> multiply(const std::vector<T>& x) const;
+
+  bool operator==(const BasicMatrix& other) const {
+    return rows_ == other.rows_ && cols_ == other.cols_ &&
+           data_ == other.data_;
+  }
+  bool operator!=(const BasicMatrix& other) const { return !(*this == other); }
+
+  // Rounded scalars go through the blocked BasicLUDecomposition for
+  // determinant(), inverse() and the DIVISION path of solve_gauss().
+  T determinant(Elimination mode = Elimination::AUTO) const;
+  BasicMatrix inverse() const;
+  // A^k by repeated squaring, about 2 log2(k) products through operator*=,
+  // so exact scalars get the Strassen path once large enough.
+  BasicMatrix pow(size_t k) const;
+  BasicMatrix transpose() const;
+  // `solver`, when given, receives the solver that was used; anything but
+  // AUTO always reports GENERAL.
+  std::vector<T> solve_gauss(std::vector<T> const& b,
+                             Elimination mode = Elimination::AUTO,
+                             MatrixStructure* solver = nullptr) const;
+  std::vector<T> solve_gauss_jordan(std::vector<T> const& b) const;
+
+  // Similar upper Hessenberg matrix. Exact scalars keep entries to EPS plus
+  // guard digits.
+  BasicMatrix hessenberg(T const& EPS = traits::epsilon()) const;
+  // Hessenberg reduction followed by Francis implicit double-shift QR with
+  // deflation, O(n^2) per iteration. Sorted by real, then imaginary part.
+  std::vector<Eigenvalue<T>> eigenvalues(T const& EPS = traits::epsilon(),
+                                         size_t max_iter = 60) const;
+  // Unit eigenvectors for the real eigenvalues, in eigenvalues() order, by
+  // inverse iteration with a slightly perturbed shift.
+  std::vector<BasicVector<T>> eigenvectors(
+      T const& EPS = traits::epsilon()) const;
+
+  size_t rank(Elimination mode = Elimination::AUTO) const;
+
+  // Bandwidths, symmetry and the resulting MatrixStructure in one O(n^2)
+  // pass over a square matrix.
+  MatrixAnalysis analyze() const;
+
+  bool is_integral() const;
+
+  // Smallest dimension at which operator* switches from the blocked kernel
+  // to Strassen-Winograd (exact scalars only). Tuned automatically on first
+  // use unless a size was forced with set_strassen_crossover (0 restores the
+  // tuned value).
+  static size_t strassen_crossover();
+  static void set_strassen_crossover(size_t size) {
+    strassen_crossover_override() = size;
+  }
+
+  // For vectors arriving one at a time, BasicSpanBasis answers both
+  // questions without refactoring the whole set.
+  static size_t span_dimension(const std::vector<std::vector<T>>& vectors) {
+    return BasicMatrix(vectors).rank();
+  }
+  // True when `vector` has unique coefficients in `basis`. To test many
+  // vectors against one basis, factor it once with BasicLUDecomposition;
+  // its solve() returns the coefficients and throws when they are not
+  // unique.
+  static bool is_in_span(const std::vector<std::vector<T>>& basis,
+                         const std::vector<T>& vector);
+  // Sparse counterparts, one vector per row, factored by BasicSparseLU.
+  // Unlike the dense overload, `vector` only has to be a combination of
+  // the basis rows; the basis need not span the whole space.
+  static size_t span_dimension(const BasicSparseMatrix<T>& vectors);
+  static bool is_in_span(const BasicSparseMatrix<T>& basis,
+                         const std::vector<T>& vector);
+
+  std::string to_string() const;
+};
+
+template <>
+std::optional<bigfloat> BasicMatrix<bigfloat>::try_modular_determinant() const;
+template <>
+std::optional<size_t> BasicMatrix<bigfloat>::try_modular_rank() const;
+template <>
+std::optional<std::vector<bigfloat>> BasicMatrix<bigfloat>::try_modular_solve(
+    std::vector<bigfloat> const& b) const;
+template <>
+std::optional<BasicMatrix<bigfloat>>
+BasicMatrix<bigfloat>::try_modular_multiply(
+    BasicMatrix<bigfloat> const& rhs) const;
+
+template <typename T>
+BasicMatrix<T>::BasicMatrix(const std::vector<std::vector<T>>& data)
+    : rows_(data.size()), cols_(data.empty() ? 0 : data[0].size()) {
+  data_.reserve(rows_ * cols_);
+  for (const auto& row : data) {
+    if (row.size() != cols_) {
+      throw std::runtime_error("Inconsistent row sizes in matrix");
+    }
+    data_.insert(data_.end(), row.begin(), row.end());
+  }
+}
+
+template <typename T>
+T& BasicMatrix<T>::at(size_t row, size_t col) {
+  if (row >= rows_ || col >= cols_) {
+    throw std::out_of_range("Matrix index out of range");
+  }
+  return (*this)(row, col);
+}
+
+template <typename T>
+const T& BasicMatrix<T>::at(size_t row, size_t col) const {
+  if (row >= rows_ || col >= cols_) {
+    throw std::out_of_range("Matrix index out of range");
+  }
+  return (*this)(row, col);
+}
+
+template <typename T>
+void BasicMatrix<T>::swap_rows(size_t first, size_t second) {
+  if (first >= rows_ || second >= rows_) {
+    throw std::out_of_range("Matrix row index out of range");
+  }
+  if (first != second) {
+    std::swap_ranges(row_data(first), row_data(first) + cols_,
+                     row_data(second));
+  }
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>::BasicMatrix(const MatrixExpression<E, T>& expression) {
+  const E& source = expression.derived();
+  rows_ = source.rows();
+  cols_ = source.cols();
+  data_.reserve(rows_ * cols_);
+  for (size_t i = 0; i < rows_; ++i) {
+    for (size_t j = 0; j < cols_; ++j) {
+      data_.push_back(source(i, j));
+    }
+  }
+}
+
+// Element (i, j) of the expression depends only on element (i, j) of its
+// operands, so writing in place is safe even when *this is one of them.
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator=(
+    const MatrixExpression<E, T>& expression) {
+  const E& source = expression.derived();
+  if (rows_ != source.rows() || cols_ != source.cols()) {
+    *this = BasicMatrix(source);
+    return *this;
+  }
+  for (size_t i = 0; i < rows_; ++i) {
+    T* row = row_data(i);
+    for (size_t j = 0; j < cols_; ++j) {
+      row[j] = source(i, j);
+    }
+  }
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator+=(const MatrixExpression<E, T>& other) {
+  const E& source = other.derived();
+  check_same_shape(*this, source, "+=");
+  for (size_t i = 0; i < rows_; ++i) {
+    T* row = row_data(i);
+    for (size_t j = 0; j < cols_; ++j) {
+      row[j] += source(i, j);
+    }
+  }
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+BasicMatrix<T>& BasicMatrix<T>::operator-=(const MatrixExpression<E, T>& other) {
+  const E& source = other.derived();
+  check_same_shape(*this, source, "-=");
+  for (size_t i = 0; i < rows_; ++i) {
+    T* row = row_data(i);
+    for (size_t j = 0; j < cols_; ++j) {
+      row[j] -= source(i, j);
+    }
+  }
+  return *this;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(const T& scalar) {
+  for (auto& value : data_) {
+    value *= scalar;
+  }
+  return *this;
+}
+
+template <typename T>
+BasicMatrix<T>& BasicMatrix<T>::operator*=(const BasicMatrix& other) {
+  if (cols_ != other.rows_) {
+    throw std::runtime_error("Matrix multiplication dimension mismatch");
+  }
+
+  if constexpr (traits::exact) {
+    const size_t smallest = std::min({rows_, cols_, other.cols_});
+    // Integer matrices go to the multi-modular engine, which is exact and
+    // spreads the work over threads without sharing a bigfloat.
+    if (smallest >= kModularMultiplySmallest) {
+      if (auto product = try_modular_multiply(other)) {
+        *this = std::move(*product);
+        return *this;
+      }
+    }
+    // Small products never pay for tuning the crossover.
+    if (smallest >= kStrassenSmallestCandidate &&
+        smallest >= strassen_crossover()) {
+      *this = multiply_strassen(*this, other, strassen_crossover());
+      return *this;
+    }
+  }
+  *this = multiply_blocked(*this, other);
+  return *this;
+}
+
+// Right-to-left binary exponentiation. The result starts as the lowest
+// power present instead of the identity, saving one product.
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::pow(size_t k) const {
+  check_square("pow");
+  if (k == 0) {
+    BasicMatrix identity(rows_, cols_);
+    for (size_t i = 0; i < rows_; ++i) {
+      identity(i, i) = T(1);
+    }
+    return identity;
+  }
+  BasicMatrix square = *this;
+  while (k % 2 == 0) {
+    square *= square;
+    k /= 2;
+  }
+  BasicMatrix result = square;
+  while (k /= 2) {
+    square *= square;
+    if (k % 2 == 1) {
+      result *= square;
+    }
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<T> BasicMatrix<T>::multiply(const std::vector<T>& x) const {
+  if (x.size() != cols_) {
+    throw std::runtime_error("Matrix size mismatch in operation: multiply");
+  }
+  std::vector<T> y(rows_);
+  for (size_t i = 0; i < rows_; ++i) {
+    const T* row = row_data(i);
+    T sum(0);
+    for (size_t j = 0; j < cols_; ++j) {
+      sum += row[j] * x[j];
+    }
+    y[i] = std::move(sum);
+  }
+  return y;
+}
+
+// Output tiles of kMultiplyTile x kMultiplyTile are independent, and run as
+// parallel_for tasks when scalar_traits<T>::parallel_kernels allows. The
+// right operand is transposed up front so both operands are read along
+// contiguous rows, and the shared dimension is walked in blocks of the same
+// size to keep the touched rows of both operands in cache. Matrix hands the
+// whole product to the packed vector kernel instead, see simd_kernels.h.
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::multiply_blocked(const BasicMatrix& lhs,
+                                                const BasicMatrix& rhs) {
+  constexpr size_t kMultiplyTile = 32;
+
+  const size_t m = lhs.rows_;
+  const size_t inner = lhs.cols_;
+  const size_t n = rhs.cols_;
+  BasicMatrix result(m, n);
+  if constexpr (traits::simd_kernels) {
+    simd_gemm(lhs.data_.data(), rhs.data_.data(), result.data_.data(), m,
+              inner, n);
+    return result;
+  }
+  const BasicMatrix rhs_t = rhs.transpose();
+
+  const size_t row_tiles = (m + kMultiplyTile - 1) / kMultiplyTile;
+  const size_t col_tiles = (n + kMultiplyTile - 1) / kMultiplyTile;
+
+  auto tile_product = [&](size_t tile) {
+    const size_t i_begin = (tile / col_tiles) * kMultiplyTile;
+    const size_t j_begin = (tile % col_tiles) * kMultiplyTile;
+    const size_t i_end = std::min(i_begin + kMultiplyTile, m);
+    const size_t j_end = std::min(j_begin + kMultiplyTile, n);
+
+    for (size_t k_begin = 0; k_begin < inner; k_begin += kMultiplyTile) {
+      const size_t k_end = std::min(k_begin + kMultiplyTile, inner);
+      for (size_t i = i_begin; i < i_end; ++i) {
+        const T* a = lhs.row_data(i);
+        T* out = result.row_data(i);
+        for (size_t j = j_begin; j < j_end; ++j) {
+          const T* b = rhs_t.row_data(j);
+          for (size_t k = k_begin; k < k_end; ++k) {
+            // A zero test is far cheaper than an exact product.
+            if (!traits::exact || (a[k] != 0 && b[k] != 0)) {
+              out[j] += a[k] * b[k];
+            }
+          }
+        }
+      }
+    }
+  };
+
+  parallel_for_if(traits::parallel_kernels &&
+                      m * n * inner >= kParallelMinimumWork,
+                  0, row_tiles * col_tiles, tile_product);
+  return result;
+}
+
+// Copies the block starting at (row, col), zero padded to rows x cols.
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::block_of(const BasicMatrix& source, size_t row,
+                                        size_t col, size_t rows, size_t cols) {
+  BasicMatrix block(rows, cols);
+  const size_t copy_rows =
+      row < source.rows() ? std::min(rows, source.rows() - row) : 0;
+  const size_t copy_cols =
+      col < source.cols() ? std::min(cols, source.cols() - col) : 0;
+  for (size_t i = 0; i < copy_rows; ++i) {
+    std::copy(source.row_data(row + i) + col,
+              source.row_data(row + i) + col + copy_cols, block.row_data(i));
+  }
+  return block;
+}
+
+// Moves the part of `block` that lies inside `target` to (row, col).
+template <typename T>
+void BasicMatrix<T>::place_block(BasicMatrix& target, BasicMatrix&& block,
+                                 size_t row, size_t col) {
+  const size_t copy_rows = std::min(block.rows(), target.rows() - row);
+  const size_t copy_cols = std::min(block.cols(), target.cols() - col);
+  for (size_t i = 0; i < copy_rows; ++i) {
+    std::move(block.row_data(i), block.row_data(i) + copy_cols,
+              target.row_data(row + i) + col);
+  }
+}
+
+// Strassen-Winograd: 7 half-size products and 15 additions per level
+// instead of 8 products. Odd dimensions are zero padded, the blocked kernel
+// skips the zero entries again.
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::multiply_strassen(const BasicMatrix& lhs,
+                                                 const BasicMatrix& rhs,
+                                                 size_t crossover) {
+  const size_t m = lhs.rows_;
+  const size_t inner = lhs.cols_;
+  const size_t n = rhs.cols_;
+  if (std::min({m, inner, n}) < std::max<size_t>(crossover, 2)) {
+    return multiply_blocked(lhs, rhs);
+  }
+
+  const size_t m2 = (m + 1) / 2;
+  const size_t k2 = (inner + 1) / 2;
+  const size_t n2 = (n + 1) / 2;
+
+  const BasicMatrix a11 = block_of(lhs, 0, 0, m2, k2);
+  const BasicMatrix a12 = block_of(lhs, 0, k2, m2, k2);
+  const BasicMatrix a21 = block_of(lhs, m2, 0, m2, k2);
+  const BasicMatrix a22 = block_of(lhs, m2, k2, m2, k2);
+  const BasicMatrix b11 = block_of(rhs, 0, 0, k2, n2);
+  const BasicMatrix b12 = block_of(rhs, 0, n2, k2, n2);
+  const BasicMatrix b21 = block_of(rhs, k2, 0, k2, n2);
+  const BasicMatrix b22 = block_of(rhs, k2, n2, k2, n2);
+
+  const BasicMatrix s1 = a21 + a22;
+  const BasicMatrix s2 = s1 - a11;
+  const BasicMatrix s3 = a11 - a21;
+  const BasicMatrix s4 = a12 - s2;
+  const BasicMatrix t1 = b12 - b11;
+  const BasicMatrix t2 = b22 - t1;
+  const BasicMatrix t3 = b22 - b12;
+  const BasicMatrix t4 = t2 - b21;
+
+  const BasicMatrix p1 = multiply_strassen(a11, b11, crossover);
+  const BasicMatrix p2 = multiply_strassen(a12, b21, crossover);
+  const BasicMatrix p3 = multiply_strassen(s4, b22, crossover);
+  const BasicMatrix p4 = multiply_strassen(a22, t4, crossover);
+  const BasicMatrix p5 = multiply_strassen(s1, t1, crossover);
+  const BasicMatrix p6 = multiply_strassen(s2, t2, crossover);
+  const BasicMatrix p7 = multiply_strassen(s3, t3, crossover);
+
+  BasicMatrix u2 = p1 + p6;
+  BasicMatrix u3 = u2 + p7;
+  BasicMatrix u4 = u2 + p5;
+
+  BasicMatrix result(m, n);
+  place_block(result, p1 + p2, 0, 0);
+  place_block(result, u4 + p3, 0, n2);
+  place_block(result, u3 - p4, m2, 0);
+  place_block(result, u3 + p5, m2, n2);
+  return result;
+}
+
+template <typename T>
+std::atomic<size_t>& BasicMatrix<T>::strassen_crossover_override() {
+  static std::atomic<size_t> forced{0};
+  return forced;
+}
+
+// Picks the smallest power-of-two size at which one Strassen level beats
+// the blocked kernel on this machine and scalar type. Measured once, on the
+// first product large enough to need the answer.
+template <typename T>
+size_t BasicMatrix<T>::strassen_crossover() {
+  if (size_t forced = strassen_crossover_override().load()) {
+    return forced;
+  }
+
+  static std::once_flag tuned;
+  static size_t crossover = kStrassenLargestCandidate * 2;
+  std::call_once(tuned, [] {
+    using clock = std::chrono::steady_clock;
+    for (size_t n = kStrassenSmallestCandidate; n <= kStrassenLargestCandidate;
+         n *= 2) {
+      BasicMatrix a(n, n);
+      BasicMatrix b(n, n);
+      for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+          a(i, j) = T(static_cast<int>((i * 31 + j * 17) % 97) - 48);
+          b(i, j) = T(static_cast<int>((i * 13 + j * 29) % 89) - 44);
+        }
+      }
+
+      const auto classical_start = clock::now();
+      multiply_blocked(a, b);
+      const auto classical = clock::now() - classical_start;
+
+      const auto strassen_start = clock::now();
+      multiply_strassen(a, b, n);
+      const auto strassen = clock::now() - strassen_start;
+
+      if (strassen < classical) {
+        crossover = n;
+        break;
+      }
+    }
+  });
+  return crossover;
+}
+
+template <typename T>
+std::string BasicMatrix<T>::to_string() const {
+  std::string result;
+  for (size_t i = 0; i < rows_; ++i) {
+    result += "(";
+    for (size_t j = 0; j < cols_; ++j) {
+      result += traits::to_string((*this)(i, j));
+      if (j + 1 < cols_) {
+        result += " ";
+      }
+    }
+    result += ") ";
+  }
+  return result;
+}
+
+template <typename T>
+bool BasicMatrix<T>::is_integral() const {
+  return std::all_of(data_.begin(), data_.end(),
+                     [](const T& value) { return traits::is_integral(value); });
+}
+
+template <typename T>
+bool BasicMatrix<T>::use_fraction_free(Elimination mode) const {
+  switch (mode) {
+    case Elimination::AUTO:
+    case Elimination::MODULAR:
+      return traits::exact && is_integral();
+    case Elimination::DIVISION:
+      return false;
+    case Elimination::FRACTION_FREE:
+      return true;
+  }
+  return false;
+}
+
+// Elimination routines pivot by permuting an index vector instead of moving
+// rows around, so a row swap is O(1) regardless of the row length.
+//
+// Position in [from, n) of the pivot for column `col`, or n if the column
+// is zero there. Exact scalars take the first nonzero entry, rounded ones
+// the largest in magnitude.
+template <typename T>
+size_t BasicMatrix<T>::select_pivot(const BasicMatrix& a,
+                                    const std::vector<size_t>& perm,
+                                    size_t from, size_t col) {
+  const size_t n = perm.size();
+  if constexpr (traits::partial_pivoting) {
+    size_t sel = n;
+    T best(0);
+    for (size_t i = from; i < n; ++i) {
+      T candidate = traits::abs(a(perm[i], col));
+      if (candidate > best) {
+        best = std::move(candidate);
+        sel = i;
+      }
+    }
+    return sel;
+  } else {
+    size_t sel = from;
+    while (sel < n && a(perm[sel], col) == T(0)) {
+      ++sel;
+    }
+    return sel;
+  }
+}
+
+template <typename T>
+T BasicMatrix<T>::determinant(Elimination mode) const {
+  check_square("determinant");
+  if (mode == Elimination::AUTO) {
+    const MatrixAnalysis analysis = analyze();
+    if (analysis.lower_bandwidth == 0 || analysis.upper_bandwidth == 0) {
+      T det(1);
+      for (size_t i = 0; i < rows_; ++i) {
+        det *= (*this)(i, i);
+      }
+      return det;
+    }
+  }
+  if (mode == Elimination::MODULAR) {
+    if (auto det = try_modular_determinant()) {
+      return *det;
+    }
+    mode = Elimination::AUTO;
+  }
+  if (use_fraction_free(mode)) {
+    return determinant_bareiss();
+  }
+  if constexpr (!traits::exact) {
+    return BasicLUDecomposition<T>(*this).determinant();
+  }
+  size_t n = rows_;
+  BasicMatrix temp = *this;
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  T det(1);
+
+  for (size_t i = 0; i < n; ++i) {
+    size_t pivot = select_pivot(temp, perm, i, i);
+    if (pivot == n) {
+      return T(0);
+    }
+
+    if (pivot != i) {
+      std::swap(perm[i], perm[pivot]);
+      det = -det;
+    }
+
+    const T* pivot_row = temp.row_data(perm[i]);
+    det *= pivot_row[i];
+
+    for (size_t j = i + 1; j < n; ++j) {
+      T* row = temp.row_data(perm[j]);
+      if (row[i] == T(0)) {
+        continue;
+      }
+      T factor = row[i] / pivot_row[i];
+
+      subtract_scaled(row + i, pivot_row + i, factor, n - i);
+    }
+  }
+
+  return det;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::inverse() const {
+  check_square("inverse");
+  if constexpr (!traits::exact) {
+    return BasicLUDecomposition<T>(*this).inverse();
+  }
+  size_t n = rows_;
+  BasicMatrix a = *this;
+  BasicMatrix inv(n, n);
+  for (size_t i = 0; i < n; ++i) {
+    inv(i, i) = T(1);
+  }
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+
+  for (size_t i = 0; i < n; ++i) {
+    size_t pivot = select_pivot(a, perm, i, i);
+    if (pivot == n) {
+      throw std::runtime_error("Singular matrix");
+    }
+
+    if (pivot != i) {
+      std::swap(perm[i], perm[pivot]);
+    }
+
+    T* a_pivot = a.row_data(perm[i]);
+    T* inv_pivot = inv.row_data(perm[i]);
+    T div = a_pivot[i];
+
+    for (size_t j = 0; j < n; ++j) {
+      a_pivot[j] /= div;
+      inv_pivot[j] /= div;
+    }
+
+    for (size_t j = 0; j < n; ++j) {
+      if (i == j) {
+        continue;
+      }
+
+      T* a_row = a.row_data(perm[j]);
+      T* inv_row = inv.row_data(perm[j]);
+      T factor = a_row[i];
+      if (factor == T(0)) {
+        continue;
+      }
+
+      subtract_scaled(a_row, a_pivot, factor, n);
+      subtract_scaled(inv_row, inv_pivot, factor, n);
+    }
+  }
+
+  BasicMatrix result(n, n);
+  for (size_t i = 0; i < n; ++i) {
+    std::move(inv.row_data(perm[i]), inv.row_data(perm[i]) + n,
+              result.row_data(i));
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<T> BasicMatrix<T>::solve_gauss(std::vector<T> const& b,
+                                           Elimination mode,
+                                           MatrixStructure* solver) const {
+  check_square("solve_gauss");
+  size_t n = rows_;
+  if (b.size() != n) {
+    throw std::runtime_error("Matrix size mismatch in operation: solve_gauss");
+  }
+  if (mode == Elimination::AUTO) {
+    if (auto solution = try_structured_solve(b, solver)) {
+      return *solution;
+    }
+  }
+  if (solver) {
+    *solver = MatrixStructure::GENERAL;
+  }
+  if (mode == Elimination::MODULAR) {
+    if (auto solution = try_modular_solve(b)) {
+      return *solution;
+    }
+    mode = Elimination::AUTO;
+  }
+  if (use_fraction_free(mode)) {
+    return solve_bareiss(b);
+  }
+  if constexpr (!traits::exact) {
+    const BasicLUDecomposition<T> lu(*this);
+    if (lu.is_singular()) {
+      throw std::runtime_error("No unique solution");
+    }
+    return lu.solve(b);
+  }
+  BasicMatrix a = *this;
+  std::vector<T> x = b;
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+
+  for (size_t i = 0; i < n; ++i) {
+    size_t pivot = select_pivot(a, perm, i, i);
+    if (pivot == n) {
+      throw std::runtime_error("No unique solution");
+    }
+
+    if (pivot != i) {
+      std::swap(perm[i], perm[pivot]);
+    }
+
+    const T* pivot_row = a.row_data(perm[i]);
+    const T& pivot_rhs = x[perm[i]];
+
+    for (size_t j = i + 1; j < n; ++j) {
+      T* row = a.row_data(perm[j]);
+      if (row[i] == T(0)) {
+        continue;
+      }
+      T factor = row[i] / pivot_row[i];
+
+      subtract_scaled(row + i, pivot_row + i, factor, n - i);
+
+      x[perm[j]] -= factor * pivot_rhs;
+    }
+  }
+
+  std::vector<T> result(n);
+  for (size_t i = n; i-- > 0;) {
+    const T* row = a.row_data(perm[i]);
+    T sum = x[perm[i]];
+    for (size_t j = i + 1; j < n; ++j) {
+      sum -= row[j] * result[j];
+    }
+
+    result[i] = sum / row[i];
+  }
+
+  return result;
+}
+
+template <typename T>
+std::vector<T> BasicMatrix<T>::solve_gauss_jordan(std::vector<T> const& b) const {
+  check_square("solve_gauss_jordan");
+  size_t n = rows_;
+  if (b.size() != n) {
+    throw std::runtime_error(
+        "Matrix size mismatch in operation: solve_gauss_jordan");
+  }
+  BasicMatrix a = *this;
+  std::vector<T> x = b;
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+
+  for (size_t i = 0; i < n; ++i) {
+    size_t pivot = select_pivot(a, perm, i, i);
+    if (pivot == n) {
+      throw std::runtime_error("No unique solution");
+    }
+
+    if (pivot != i) {
+      std::swap(perm[i], perm[pivot]);
+    }
+
+    T* pivot_row = a.row_data(perm[i]);
+    T div = pivot_row[i];
+
+    for (size_t j = i; j < n; ++j) {
+      pivot_row[j] /= div;
+    }
+
+    x[perm[i]] /= div;
+
+    for (size_t j = 0; j < n; ++j) {
+      if (j == i) {
+        continue;
+      }
+
+      T* row = a.row_data(perm[j]);
+      T factor = row[i];
+      if (factor == T(0)) {
+        continue;
+      }
+
+      subtract_scaled(row + i, pivot_row + i, factor, n - i);
+
+      x[perm[j]] -= factor * x[perm[i]];
+    }
+  }
+
+  std::vector<T> result(n);
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = std::move(x[perm[i]]);
+  }
+  return result;
+}
+
+template <typename T>
+MatrixAnalysis BasicMatrix<T>::analyze() const {
+  check_square("analyze");
+  const size_t n = rows_;
+  MatrixAnalysis analysis;
+  analysis.symmetric = true;
+  for (size_t i = 0; i < n; ++i) {
+    const T* row = row_data(i);
+    for (size_t j = 0; j < n; ++j) {
+      if (row[j] == T(0)) {
+        continue;
+      }
+      if (j < i) {
+        analysis.lower_bandwidth = std::max(analysis.lower_bandwidth, i - j);
+      } else if (j > i) {
+        analysis.upper_bandwidth = std::max(analysis.upper_bandwidth, j - i);
+      }
+    }
+    for (size_t j = i + 1; j < n && analysis.symmetric; ++j) {
+      analysis.symmetric = row[j] == (*this)(j, i);
+    }
+  }
+
+  const size_t lower = analysis.lower_bandwidth;
+  const size_t upper = analysis.upper_bandwidth;
+  if (lower == 0 && upper == 0) {
+    analysis.structure = MatrixStructure::DIAGONAL;
+  } else if (lower == 0) {
+    analysis.structure = MatrixStructure::UPPER_TRIANGULAR;
+  } else if (upper == 0) {
+    analysis.structure = MatrixStructure::LOWER_TRIANGULAR;
+  } else if (lower == 1 && upper == 1) {
+    analysis.structure = MatrixStructure::TRIDIAGONAL;
+  } else if (4 * (lower + upper) < n) {
+    // Narrow enough that band elimination beats dense elimination by a
+    // wide margin.
+    analysis.structure = MatrixStructure::BANDED;
+  } else if (analysis.symmetric) {
+    analysis.structure = MatrixStructure::SYMMETRIC;
+  }
+  return analysis;
+}
+
+template <typename T>
+std::optional<std::vector<T>> BasicMatrix<T>::try_structured_solve(
+    std::vector<T> const& b, MatrixStructure* solver) const {
+  const MatrixAnalysis analysis = analyze();
+  std::optional<std::vector<T>> solution;
+  switch (analysis.structure) {
+    case MatrixStructure::DIAGONAL:
+      solution = solve_diagonal(b);
+      break;
+    case MatrixStructure::LOWER_TRIANGULAR:
+      solution = solve_triangular(b, true);
+      break;
+    case MatrixStructure::UPPER_TRIANGULAR:
+      solution = solve_triangular(b, false);
+      break;
+    case MatrixStructure::TRIDIAGONAL:
+    case MatrixStructure::BANDED:
+      solution = solve_banded(b, analysis.lower_bandwidth,
+                              analysis.upper_bandwidth);
+      break;
+    case MatrixStructure::SYMMETRIC:
+      if (!use_fraction_free(Elimination::AUTO)) {
+        solution = solve_ldlt(b);
+      }
+      break;
+    case MatrixStructure::GENERAL:
+      break;
+  }
+  if (solution && solver) {
+    *solver = analysis.structure;
+  }
+  return solution;
+}
+
+template <typename T>
+std::vector<T> BasicMatrix<T>::solve_diagonal(std::vector<T> const& b) const {
+  std::vector<T> x(rows_);
+  for (size_t i = 0; i < rows_; ++i) {
+    if ((*this)(i, i) == T(0)) {
+      throw std::runtime_error("No unique solution");
+    }
+    x[i] = b[i] / (*this)(i, i);
+  }
+  return x;
+}
+
+template <typename T>
+std::vector<T> BasicMatrix<T>::solve_triangular(std::vector<T> const& b,
+                                                bool lower) const {
+  const size_t n = rows_;
+  std::vector<T> x(n);
+  for (size_t step = 0; step < n; ++step) {
+    const size_t i = lower ? step : n - 1 - step;
+    const T* row = row_data(i);
+    if (row[i] == T(0)) {
+      throw std::runtime_error("No unique solution");
+    }
+    T sum = b[i];
+    const size_t first = lower ? 0 : i + 1;
+    const size_t last = lower ? i : n;
+    for (size_t j = first; j < last; ++j) {
+      if (row[j] != T(0)) {
+        sum -= row[j] * x[j];
+      }
+    }
+    x[i] = sum / row[i];
+  }
+  return x;
+}
+
+// Row swaps can push the upper bandwidth of U to lower + upper; nothing
+// outside that band is ever read or written.
+template <typename T>
+std::vector<T> BasicMatrix<T>::solve_banded(std::vector<T> const& b,
+                                            size_t lower, size_t upper) const {
+  const size_t n = rows_;
+  const size_t width = lower + upper;
+  BasicMatrix a = *this;
+  std::vector<T> x = b;
+
+  for (size_t i = 0; i < n; ++i) {
+    const size_t last_row = std::min(n, i + lower + 1);
+    const size_t last_col = std::min(n, i + width + 1);
+
+    size_t sel = i;
+    if constexpr (traits::partial_pivoting) {
+      T best = traits::abs(a(i, i));
+      for (size_t j = i + 1; j < last_row; ++j) {
+        T candidate = traits::abs(a(j, i));
+        if (candidate > best) {
+          best = std::move(candidate);
+          sel = j;
+        }
+      }
+    } else {
+      while (sel + 1 < last_row && a(sel, i) == T(0)) {
+        ++sel;
+      }
+    }
+    if (a(sel, i) == T(0)) {
+      throw std::runtime_error("No unique solution");
+    }
+    if (sel != i) {
+      std::swap_ranges(a.row_data(i) + i, a.row_data(i) + last_col,
+                       a.row_data(sel) + i);
+      std::swap(x[i], x[sel]);
+    }
+
+    const T* pivot_row = a.row_data(i);
+    for (size_t j = i + 1; j < last_row; ++j) {
+      T* row = a.row_data(j);
+      if (row[i] == T(0)) {
+        continue;
+      }
+      T factor = row[i] / pivot_row[i];
+      subtract_scaled(row + i, pivot_row + i, factor, last_col - i);
+      x[j] -= factor * x[i];
+    }
+  }
+
+  std::vector<T> result(n);
+  for (size_t i = n; i-- > 0;) {
+    const T* row = a.row_data(i);
+    T sum = std::move(x[i]);
+    const size_t last_col = std::min(n, i + width + 1);
+    for (size_t j = i + 1; j < last_col; ++j) {
+      if (row[j] != T(0)) {
+        sum -= row[j] * result[j];
+      }
+    }
+    result[i] = sum / row[i];
+  }
+  return result;
+}
+
+// Row j of L is finished before it is needed: l(i, j) only reads the first
+// j entries of rows i and j, and ld holds row j of L scaled by D.
+template <typename T>
+std::optional<std::vector<T>> BasicMatrix<T>::solve_ldlt(
+    std::vector<T> const& b) const {
+  const size_t n = rows_;
+  BasicMatrix l(n, n);
+  std::vector<T> d(n);
+  std::vector<T> ld(n);
+
+  for (size_t j = 0; j < n; ++j) {
+    const T* l_j = l.row_data(j);
+    T pivot = (*this)(j, j);
+    for (size_t k = 0; k < j; ++k) {
+      ld[k] = l_j[k] * d[k];
+      pivot -= l_j[k] * ld[k];
+    }
+    if (pivot == T(0) || (!traits::exact && pivot < T(0))) {
+      return std::nullopt;
+    }
+    for (size_t i = j + 1; i < n; ++i) {
+      const T* l_i = l.row_data(i);
+      T sum = (*this)(i, j);
+      for (size_t k = 0; k < j; ++k) {
+        if (l_i[k] != T(0)) {
+          sum -= l_i[k] * ld[k];
+        }
+      }
+      l(i, j) = sum / pivot;
+    }
+    d[j] = std::move(pivot);
+  }
+
+  std::vector<T> x = b;
+  for (size_t i = 0; i < n; ++i) {
+    const T* l_i = l.row_data(i);
+    for (size_t k = 0; k < i; ++k) {
+      if (l_i[k] != T(0)) {
+        x[i] -= l_i[k] * x[k];
+      }
+    }
+  }
+  for (size_t i = 0; i < n; ++i) {
+    x[i] /= d[i];
+  }
+  for (size_t i = n; i-- > 0;) {
+    for (size_t k = i + 1; k < n; ++k) {
+      if (l(k, i) != T(0)) {
+        x[i] -= l(k, i) * x[k];
+      }
+    }
+  }
+  return x;
+}
+
+// Rank always pivots on the largest entry; rounded scalars treat entries
+// below traits::tolerance() as zero.
+template <typename T>
+size_t BasicMatrix<T>::rank(Elimination mode) const {
+  if (mode == Elimination::MODULAR) {
+    if (auto rank = try_modular_rank()) {
+      return *rank;
+    }
+    mode = Elimination::AUTO;
+  }
+  if (use_fraction_free(mode)) {
+    return rank_bareiss();
+  }
+  BasicMatrix temp = *this;
+  size_t rank = 0;
+  size_t m = rows_;
+  size_t n = cols_;
+  std::vector<size_t> perm(m);
+  std::iota(perm.begin(), perm.end(), 0);
+
+  for (size_t col = 0, row = 0; col < n && row < m; ++col) {
+    size_t sel = row;
+    T best = traits::abs(temp(perm[sel], col));
+    for (size_t i = row + 1; i < m; ++i) {
+      T candidate = traits::abs(temp(perm[i], col));
+      if (candidate > best) {
+        best = std::move(candidate);
+        sel = i;
+      }
+    }
+
+    if (best == T(0) || (!traits::exact && best < traits::tolerance())) {
+      continue;
+    }
+
+    if (sel != row) {
+      std::swap(perm[row], perm[sel]);
+    }
+
+    const T* pivot_row = temp.row_data(perm[row]);
+
+    for (size_t i = row + 1; i < m; ++i) {
+      T* current = temp.row_data(perm[i]);
+      if (current[col] == T(0)) {
+        continue;
+      }
+      T factor = current[col] / pivot_row[col];
+
+      subtract_scaled(current + col, pivot_row + col, factor, n - col);
+    }
+
+    ++rank;
+    ++row;
+  }
+
+  return rank;
+}
+
+// Bareiss elimination keeps every intermediate entry equal to a minor of
+// the input, so after the update
+//   a(i, j) = (a(i, j) * a(k, k) - a(i, k) * a(k, j)) / previous pivot
+// the division is exact and integer input stays integer.
+
+template <typename T>
+T BasicMatrix<T>::determinant_bareiss() const {
+  size_t n = rows_;
+  BasicMatrix temp = *this;
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  T previous(1);
+  bool negate = false;
+
+  for (size_t k = 0; k < n; ++k) {
+    size_t pivot = k;
+    while (pivot < n && temp(perm[pivot], k) == T(0)) {
+      ++pivot;
+    }
+    if (pivot == n) {
+      return T(0);
+    }
+    if (pivot != k) {
+      std::swap(perm[k], perm[pivot]);
+      negate = !negate;
+    }
+
+    const T* pivot_row = temp.row_data(perm[k]);
+    for (size_t i = k + 1; i < n; ++i) {
+      T* row = temp.row_data(perm[i]);
+      for (size_t j = k + 1; j < n; ++j) {
+        row[j] = row[j] * pivot_row[k] - row[k] * pivot_row[j];
+        if (k != 0) {
+          row[j] /= previous;
+        }
+      }
+    }
+    previous = pivot_row[k];
+  }
+
+  return negate ? -previous : previous;
+}
+
+template <typename T>
+size_t BasicMatrix<T>::rank_bareiss() const {
+  BasicMatrix temp = *this;
+  size_t m = rows_;
+  size_t n = cols_;
+  std::vector<size_t> perm(m);
+  std::iota(perm.begin(), perm.end(), 0);
+  T previous(1);
+  size_t row = 0;
+
+  for (size_t col = 0; col < n && row < m; ++col) {
+    size_t sel = row;
+    while (sel < m && temp(perm[sel], col) == T(0)) {
+      ++sel;
+    }
+    if (sel == m) {
+      continue;
+    }
+    if (sel != row) {
+      std::swap(perm[row], perm[sel]);
+    }
+
+    const T* pivot_row = temp.row_data(perm[row]);
+    for (size_t i = row + 1; i < m; ++i) {
+      T* current = temp.row_data(perm[i]);
+      for (size_t j = col + 1; j < n; ++j) {
+        current[j] = current[j] * pivot_row[col] - current[col] * pivot_row[j];
+        if (row != 0) {
+          current[j] /= previous;
+        }
+      }
+      current[col] = T(0);
+    }
+    previous = pivot_row[col];
+    ++row;
+  }
+
+  return row;
+}
+
+template <typename T>
+std::vector<T> BasicMatrix<T>::solve_bareiss(std::vector<T> const& b) const {
+  size_t n = rows_;
+  BasicMatrix a(n, n + 1);
+  for (size_t i = 0; i < n; ++i) {
+    std::copy(row_data(i), row_data(i) + n, a.row_data(i));
+    a(i, n) = b[i];
+  }
+  std::vector<size_t> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  T previous(1);
+
+  for (size_t k = 0; k < n; ++k) {
+    size_t pivot = k;
+    while (pivot < n && a(perm[pivot], k) == T(0)) {
+      ++pivot;
+    }
+    if (pivot == n) {
+      throw std::runtime_error("No unique solution");
+    }
+    if (pivot != k) {
+      std::swap(perm[k], perm[pivot]);
+    }
+
+    const T* pivot_row = a.row_data(perm[k]);
+    for (size_t i = k + 1; i < n; ++i) {
+      T* row = a.row_data(perm[i]);
+      for (size_t j = k + 1; j <= n; ++j) {
+        row[j] = row[j] * pivot_row[k] - row[k] * pivot_row[j];
+        if (k != 0) {
+          row[j] /= previous;
+        }
+      }
+    }
+    previous = pivot_row[k];
+  }
+
+  std::vector<T> result(n);
+  for (size_t i = n; i-- > 0;) {
+    const T* row = a.row_data(perm[i]);
+    T sum = row[n];
+    for (size_t j = i + 1; j < n; ++j) {
+      sum -= row[j] * result[j];
+    }
+    result[i] = sum / row[i];
+  }
+
+  return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::hessenberg(T const& EPS) const {
+  check_square("hessenberg");
+  const size_t n = rows_;
+  const size_t digits = traits::decimal_places(EPS) + kEigenGuardDigits;
+  BasicMatrix h = *this;
+  std::vector<T> v(n);
+
+  for (size_t k = 0; k + 2 < n; ++k) {
+    T norm2(0);
+    for (size_t i = k + 1; i < n; ++i) {
+      norm2 += h(i, k) * h(i, k);
+    }
+    if (norm2 == T(0)) {
+      continue;
+    }
+    const T norm = traits::rounded(traits::sqrt(norm2, EPS), digits);
+    const T alpha = h(k + 1, k) > T(0) ? -norm : norm;
+
+    T v_norm2(0);
+    for (size_t i = k + 1; i < n; ++i) {
+      v[i] = i == k + 1 ? h(i, k) - alpha : h(i, k);
+      v_norm2 += v[i] * v[i];
+    }
+    if (v_norm2 == T(0)) {
+      continue;
+    }
+    const T scale = traits::rounded(T(2) / v_norm2, digits);
+
+    for (size_t j = k; j < n; ++j) {
+      T s(0);
+      for (size_t i = k + 1; i < n; ++i) {
+        s += v[i] * h(i, j);
+      }
+      s *= scale;
+      for (size_t i = k + 1; i < n; ++i) {
+        h(i, j) -= s * v[i];
+      }
+    }
+    for (size_t i = 0; i < n; ++i) {
+      T* row = h.row_data(i);
+      T s(0);
+      for (size_t j = k + 1; j < n; ++j) {
+        s += row[j] * v[j];
+      }
+      s *= scale;
+      for (size_t j = k + 1; j < n; ++j) {
+        row[j] -= s * v[j];
+      }
+    }
+    for (size_t i = k + 2; i < n; ++i) {
+      h(i, k) = T(0);
+    }
+    if constexpr (traits::exact) {
+      for (auto& value : h.data_) {
+        value = traits::rounded(value, digits);
+      }
+    }
+  }
+
+  return h;
+}
+
+template <typename T>
+std::vector<Eigenvalue<T>> BasicMatrix<T>::eigenvalues(T const& EPS,
+                                                       size_t max_iter) const {
+  check_square("eigenvalues");
+  const int n = static_cast<int>(rows_);
+  const size_t digits = traits::decimal_places(EPS) + kEigenGuardDigits;
+  BasicMatrix a = hessenberg(EPS);
+  std::vector<Eigenvalue<T>> result(n);
+
+  auto signed_like = [](const T& magnitude, const T& sign) {
+    return sign < T(0) ? -traits::abs(magnitude) : traits::abs(magnitude);
+  };
+
+  T anorm(0);
+  for (int i = 0; i < n; ++i) {
+    for (int j = std::max(i - 1, 0); j < n; ++j) {
+      anorm += traits::abs(a(i, j));
+    }
+  }
+
+  int nn = n - 1;
+  T t(0);
+  while (nn >= 0) {
+    size_t its = 0;
+    int l;
+    do {
+      for (l = nn; l >= 1; --l) {
+        T s = traits::abs(a(l - 1, l - 1)) + traits::abs(a(l, l));
+        if (s == T(0)) {
+          s = anorm;
+        }
+        if (traits::abs(a(l, l - 1)) <= EPS * s) {
+          a(l, l - 1) = T(0);
+          break;
+        }
+      }
+      T x = a(nn, nn);
+      if (l == nn) {
+        result[nn--] = {x + t, T(0)};
+        continue;
+      }
+      T y = a(nn - 1, nn - 1);
+      T w = a(nn, nn - 1) * a(nn - 1, nn);
+      if (l == nn - 1) {
+        T p = (y - x) / T(2);
+        T q = p * p + w;
+        T z = traits::sqrt(traits::abs(q), EPS);
+        x += t;
+        if (q >= T(0)) {
+          z = p + signed_like(z, p);
+          result[nn - 1] = {x + z, T(0)};
+          result[nn] = {z != T(0) ? x - w / z : x + z, T(0)};
+        } else {
+          result[nn - 1] = {x + p, z};
+          result[nn] = {x + p, -z};
+        }
+        nn -= 2;
+        continue;
+      }
+      if (its == max_iter) {
+        throw std::runtime_error("eigenvalues: QR iteration did not converge");
+      }
+      if (its % 10 == 9) {
+        // Exceptional shift to break cycles.
+        t += x;
+        for (int i = 0; i <= nn; ++i) {
+          a(i, i) -= x;
+        }
+        T s = traits::abs(a(nn, nn - 1)) + traits::abs(a(nn - 1, nn - 2));
+        x = s * T(3) / T(4);
+        y = x;
+        w = -(s * s * T(7) / T(16));
+      }
+      ++its;
+
+      int m;
+      T p(0), q(0), r(0), z(0);
+      for (m = nn - 2; m >= l; --m) {
+        z = a(m, m);
+        r = x - z;
+        T s = y - z;
+        p = (r * s - w) / a(m + 1, m) + a(m, m + 1);
+        q = a(m + 1, m + 1) - z - r - s;
+        r = a(m + 2, m + 1);
+        s = traits::abs(p) + traits::abs(q) + traits::abs(r);
+        p /= s;
+        q /= s;
+        r /= s;
+        if (m == l) {
+          break;
+        }
+        T u = traits::abs(a(m, m - 1)) * (traits::abs(q) + traits::abs(r));
+        T v = traits::abs(p) * (traits::abs(a(m - 1, m - 1)) + traits::abs(z) +
+                                traits::abs(a(m + 1, m + 1)));
+        if (u <= EPS * v) {
+          break;
+        }
+      }
+      for (int i = m + 2; i <= nn; ++i) {
+        a(i, i - 2) = T(0);
+        if (i != m + 2) {
+          a(i, i - 3) = T(0);
+        }
+      }
+
+      for (int k = m; k <= nn - 1; ++k) {
+        if (k != m) {
+          p = a(k, k - 1);
+          q = a(k + 1, k - 1);
+          r = k != nn - 1 ? a(k + 2, k - 1) : T(0);
+          x = traits::abs(p) + traits::abs(q) + traits::abs(r);
+          if (x != T(0)) {
+            p /= x;
+            q /= x;
+            r /= x;
+          }
+        }
+        T s = signed_like(traits::sqrt(p * p + q * q + r * r, EPS), p);
+        if (s == T(0)) {
+          continue;
+        }
+        if (k == m) {
+          if (l != m) {
+            a(k, k - 1) = -a(k, k - 1);
+          }
+        } else {
+          a(k, k - 1) = -(s * x);
+        }
+        p += s;
+        x = p / s;
+        y = q / s;
+        z = r / s;
+        q /= p;
+        r /= p;
+        for (int j = k; j <= nn; ++j) {
+          p = a(k, j) + q * a(k + 1, j);
+          if (k != nn - 1) {
+            p += r * a(k + 2, j);
+            a(k + 2, j) -= p * z;
+          }
+          a(k + 1, j) -= p * y;
+          a(k, j) -= p * x;
+        }
+        const int last = std::min(nn, k + 3);
+        for (int i = l; i <= last; ++i) {
+          p = x * a(i, k) + y * a(i, k + 1);
+          if (k != nn - 1) {
+            p += z * a(i, k + 2);
+            a(i, k + 2) -= p * r;
+          }
+          a(i, k + 1) -= p * q;
+          a(i, k) -= p;
+        }
+      }
+
+      if constexpr (traits::exact) {
+        for (int i = 0; i <= nn; ++i) {
+          for (int j = std::max(i - 1, 0); j <= nn; ++j) {
+            a(i, j) = traits::rounded(a(i, j), digits);
+          }
+        }
+        t = traits::rounded(t, digits);
+      }
+    } while (nn >= 0 && l < nn - 1);
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const Eigenvalue<T>& lhs, const Eigenvalue<T>& rhs) {
+              return lhs.re != rhs.re ? lhs.re < rhs.re : lhs.im < rhs.im;
+            });
+  return result;
+}
+
+template <typename T>
+std::vector<BasicVector<T>> BasicMatrix<T>::eigenvectors(T const& EPS) const {
+  constexpr size_t kInverseIterations = 3;
+  const size_t n = rows_;
+  const size_t digits = traits::decimal_places(EPS) + kEigenGuardDigits;
+
+  T scale(1);
+  for (const auto& value : data_) {
+    if (traits::abs(value) > scale) {
+      scale = traits::abs(value);
+    }
+  }
+  // Keeps A - lambda I away from exact singularity. In rounded arithmetic
+  // EPS is too close to the noise in lambda itself.
+  const T delta = scale * (traits::exact ? EPS : traits::tolerance());
+
+  std::vector<BasicVector<T>> result;
+  for (const auto& lambda : eigenvalues(EPS)) {
+    if (lambda.im != T(0)) {
+      continue;
+    }
+    BasicMatrix shifted = *this;
+    for (size_t i = 0; i < n; ++i) {
+      shifted(i, i) -= lambda.re + delta;
+    }
+    const BasicLUDecomposition<T> lu(shifted);
+    if (lu.is_singular()) {
+      continue;
+    }
+
+    BasicVector<T> x(std::vector<T>(n, T(1)));
+    for (size_t iter = 0; iter < kInverseIterations; ++iter) {
+      std::vector<T> next = lu.solve(x.components());
+      for (auto& value : next) {
+        value = traits::rounded(value, digits);
+      }
+      x = BasicVector<T>(next).normalize(EPS);
+    }
+    result.push_back(std::move(x));
+  }
+  return result;
+}
+
+template <typename T>
+bool BasicMatrix<T>::is_in_span(const std::vector<std::vector<T>>& basis,
+                                const std::vector<T>& vector) {
+  try {
+    BasicMatrix(basis).solve_gauss(vector);
+    return true;
+  } catch (std::exception const&) {
+    return false;
+  }
+}
+
+template <typename T>
+size_t BasicMatrix<T>::span_dimension(const BasicSparseMatrix<T>& vectors) {
+  return BasicSparseLU<T>(vectors).rank();
+}
+
+template <typename T>
+bool BasicMatrix<T>::is_in_span(const BasicSparseMatrix<T>& basis,
+                                const std::vector<T>& vector) {
+  BasicSparseMatrix<T> extended = basis;
+  extended.append_row(vector);
+  return BasicSparseLU<T>(extended).rank() == span_dimension(basis);
+}
+
+template <typename T>
+BasicMatrix<T> BasicMatrix<T>::transpose() const {
+  BasicMatrix result(cols_, rows_);
+  if constexpr (traits::simd_kernels) {
+    simd_transpose(data_.data(), result.data_.data(), rows_, cols_);
+    return result;
+  }
+  for (size_t i = 0; i < rows_; ++i) {
+    const T* row = row_data(i);
+    for (size_t j = 0; j < cols_; ++j) {
+      result(j, i) = row[j];
+    }
+  }
+  return result;
+}
+
+extern template class BasicMatrix<bigfloat>;
+
+#include "BasicLUDecomposition.h"
+#include "BasicSparseLU.h"
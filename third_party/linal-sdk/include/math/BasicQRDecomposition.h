@@ -0,0 +1,437 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicMatrix.h"
+#include "BasicVector.h"
+#include "parallel_for.h"
+#include "scalar_traits.h"
+#include "simd_kernels.h"
+
+// A P = Q R by Householder reflections, for any m x n matrix. QRDecomposition
+// and QRDecompositionBF are the double and bigfloat instances.
+//
+// Reflector k is H_k = I - tau_k v_k v_k^T with v_k(k) = 1; the rest of v_k
+// is packed below the diagonal of R, as in LAPACK. Without pivoting the
+// factorization is blocked: each panel of kBlock columns is factored on its
+// own, its reflectors are combined into the compact WY form
+// H_begin ... H_end-1 = I - V T V^T, and the trailing matrix receives
+//   A2 -= V (T^T (V^T A2))
+// one tile of columns at a time, walking A2 along its rows. The tiles are
+// parallel_for tasks when scalar_traits<T>::parallel_kernels allows.
+//
+// With pivoting, each step brings forward the remaining column of largest
+// norm (Businger-Golub). |r_kk| then decreases, so rank() is reliable and
+// solve() returns a basic least-squares solution for rank-deficient A. The
+// pivoted factorization updates column norms at every step and so is not
+// blocked.
+//
+// Square roots are inexact in bigfloat, so exact scalars keep entries to
+// EPS plus kGuardDigits decimal places, like the eigen solvers.
+template <typename T>
+class BasicQRDecomposition {
+ private:
+  using traits = scalar_traits<T>;
+
+  static constexpr size_t kBlock = 32;
+  static constexpr size_t kTile = 64;
+  static constexpr size_t kGuardDigits = 10;
+
+  BasicMatrix<T> qr_;
+  std::vector<T> tau_;
+  std::vector<size_t> perm_;
+  size_t rank_{};
+  bool pivoted_{};
+  size_t digits_{};
+  T eps_{};
+
+  size_t steps() const noexcept { return std::min(qr_.rows(), qr_.cols()); }
+
+  void factor_panel(size_t begin, size_t end, bool pivoting);
+  void update_trailing(size_t begin, size_t end);
+  // b := Q^T b = H_last ... H_0 b when `transpose`, else b := Q b.
+  void apply_reflectors(std::vector<T>& b, bool transpose) const;
+
+ public:
+  BasicQRDecomposition() = default;
+  explicit BasicQRDecomposition(const BasicMatrix<T>& matrix,
+                                bool pivoting = false,
+                                const T& EPS = traits::epsilon());
+
+  size_t rows() const noexcept { return qr_.rows(); }
+  size_t cols() const noexcept { return qr_.cols(); }
+
+  // Number of |r_kk| above the tolerance relative to |r_00|. Only
+  // rank-revealing when the factorization was pivoted.
+  size_t rank() const noexcept { return rank_; }
+  // Column k of A P is column permutation()[k] of A.
+  const std::vector<size_t>& permutation() const noexcept { return perm_; }
+
+  // Thin factors: Q is m x min(m, n) with orthonormal columns, R is
+  // min(m, n) x n upper triangular.
+  BasicMatrix<T> q() const;
+  BasicMatrix<T> r() const;
+  // The first rank() columns of Q, an orthonormal basis of the column
+  // space of A when pivoted.
+  std::vector<BasicVector<T>> orthonormal_basis() const;
+
+  // x minimising ||A x - b||. Needs full column rank unless pivoted, in
+  // which case the components past rank() in pivot order are zero.
+  std::vector<T> solve(const std::vector<T>& b) const;
+};
+
+template <typename T>
+BasicQRDecomposition<T>::BasicQRDecomposition(const BasicMatrix<T>& matrix,
+                                              bool pivoting, const T& EPS)
+    : qr_(matrix),
+      tau_(std::min(matrix.rows(), matrix.cols()), T(0)),
+      perm_(matrix.cols()),
+      pivoted_(pivoting),
+      digits_(traits::decimal_places(EPS) + kGuardDigits),
+      eps_(EPS) {
+  std::iota(perm_.begin(), perm_.end(), 0);
+  if (pivoting) {
+    factor_panel(0, cols(), true);
+  } else {
+    for (size_t begin = 0; begin < steps(); begin += kBlock) {
+      const size_t end = std::min(begin + kBlock, steps());
+      factor_panel(begin, end, false);
+      if (end < cols()) {
+        update_trailing(begin, end);
+      }
+    }
+  }
+
+  if (steps() == 0) {
+    return;
+  }
+  const T tolerance =
+      traits::abs(qr_(0, 0)) *
+      (traits::exact ? eps_ * T(1000) : traits::tolerance());
+  for (size_t k = 0; k < steps(); ++k) {
+    if (traits::abs(qr_(k, k)) > tolerance) {
+      ++rank_;
+    }
+  }
+}
+
+// Unblocked Householder QR on columns [begin, end): reflector k is applied
+// to columns k + 1 .. end - 1 only. Row-major storage makes both halves of
+// the application, w = v^T A and A -= tau v w, sweeps along rows.
+template <typename T>
+void BasicQRDecomposition<T>::factor_panel(size_t begin, size_t end,
+                                           bool pivoting) {
+  const size_t m = rows();
+  const size_t last = std::min(end, m);
+  for (size_t k = begin; k < last; ++k) {
+    if (pivoting) {
+      size_t sel = k;
+      T best(-1);
+      for (size_t col = k; col < end; ++col) {
+        T norm(0);
+        for (size_t i = k; i < m; ++i) {
+          norm += qr_(i, col) * qr_(i, col);
+        }
+        if (norm > best) {
+          best = std::move(norm);
+          sel = col;
+        }
+      }
+      if (sel != k) {
+        for (size_t i = 0; i < m; ++i) {
+          std::swap(qr_(i, k), qr_(i, sel));
+        }
+        std::swap(perm_[k], perm_[sel]);
+      }
+    }
+
+    T norm(0);
+    for (size_t i = k; i < m; ++i) {
+      norm += qr_(i, k) * qr_(i, k);
+    }
+    if (norm == T(0)) {
+      tau_[k] = T(0);
+      continue;
+    }
+    const T alpha = qr_(k, k);
+    T beta = traits::rounded(traits::sqrt(norm, eps_), digits_);
+    if (alpha > T(0)) {
+      beta = -beta;
+    }
+    const T scale = alpha - beta;
+    if (scale == T(0)) {
+      tau_[k] = T(0);
+      continue;
+    }
+    for (size_t i = k + 1; i < m; ++i) {
+      qr_(i, k) = traits::rounded(qr_(i, k) / scale, digits_);
+    }
+    tau_[k] = traits::rounded((beta - alpha) / beta, digits_);
+    qr_(k, k) = beta;
+
+    const size_t width = end - k - 1;
+    if (width == 0) {
+      continue;
+    }
+    std::vector<T> w(qr_.row_data(k) + k + 1, qr_.row_data(k) + end);
+    for (size_t i = k + 1; i < m; ++i) {
+      if (qr_(i, k) != T(0)) {
+        subtract_scaled(w.data(), qr_.row_data(i) + k + 1, -qr_(i, k),
+                        width);
+      }
+    }
+    for (auto& value : w) {
+      value *= tau_[k];
+    }
+    subtract_scaled(qr_.row_data(k) + k + 1, w.data(), T(1), width);
+    for (size_t i = k + 1; i < m; ++i) {
+      if (qr_(i, k) != T(0)) {
+        subtract_scaled(qr_.row_data(i) + k + 1, w.data(), qr_(i, k), width);
+      }
+    }
+    if constexpr (traits::exact) {
+      for (size_t i = k; i < m; ++i) {
+        for (size_t col = k + 1; col < end; ++col) {
+          qr_(i, col) = traits::rounded(qr_(i, col), digits_);
+        }
+      }
+    }
+  }
+}
+
+// T is upper triangular with T_jj = tau_j and
+//   T(0:j, j) = -tau_j T(0:j, 0:j) V(:, 0:j)^T v_j,
+// then every tile of trailing columns gets W = T^T V^T A2 and A2 -= V W.
+template <typename T>
+void BasicQRDecomposition<T>::update_trailing(size_t begin, size_t end) {
+  const size_t m = rows();
+  const size_t n = cols();
+  const size_t b = end - begin;
+  // v(i, j) for rows i >= begin; v_j is 1 at row begin + j, 0 above it.
+  auto v = [&](size_t i, size_t j) -> T {
+    const size_t col = begin + j;
+    if (i < col) {
+      return T(0);
+    }
+    return i == col ? T(1) : qr_(i, col);
+  };
+
+  BasicMatrix<T> t(b, b);
+  for (size_t j = 0; j < b; ++j) {
+    t(j, j) = tau_[begin + j];
+    std::vector<T> dots(j, T(0));
+    for (size_t l = 0; l < j; ++l) {
+      for (size_t i = begin + j; i < m; ++i) {
+        dots[l] += v(i, l) * v(i, j);
+      }
+    }
+    for (size_t l = 0; l < j; ++l) {
+      T sum(0);
+      for (size_t p = l; p < j; ++p) {
+        sum += t(l, p) * dots[p];
+      }
+      t(l, j) = traits::rounded(-tau_[begin + j] * sum, digits_);
+    }
+  }
+
+  const size_t width = n - end;
+  const size_t tiles = (width + kTile - 1) / kTile;
+  // Three passes of about b multiply-adds per entry of A2.
+  const bool parallel = traits::parallel_kernels &&
+                        3 * b * (m - begin) * width >= kParallelMinimumWork;
+  parallel_for_if(parallel, 0, tiles, [&](size_t tile) {
+    const size_t first = end + tile * kTile;
+    const size_t count = std::min(kTile, n - first);
+
+    BasicMatrix<T> w(b, count);
+    for (size_t i = begin; i < m; ++i) {
+      const T* row = qr_.row_data(i) + first;
+      for (size_t j = 0; j < b && begin + j <= i; ++j) {
+        const T weight = v(i, j);
+        if (weight != T(0)) {
+          subtract_scaled(w.row_data(j), row, -weight, count);
+        }
+      }
+    }
+
+    BasicMatrix<T> tw(b, count);
+    for (size_t j = 0; j < b; ++j) {
+      for (size_t l = 0; l <= j; ++l) {
+        if (t(l, j) != T(0)) {
+          subtract_scaled(tw.row_data(j), w.row_data(l), -t(l, j), count);
+        }
+      }
+    }
+
+    for (size_t i = begin; i < m; ++i) {
+      T* row = qr_.row_data(i) + first;
+      for (size_t j = 0; j < b && begin + j <= i; ++j) {
+        const T weight = v(i, j);
+        if (weight != T(0)) {
+          subtract_scaled(row, tw.row_data(j), weight, count);
+        }
+      }
+      if constexpr (traits::exact) {
+        for (size_t col = 0; col < count; ++col) {
+          row[col] = traits::rounded(row[col], digits_);
+        }
+      }
+    }
+  });
+}
+
+template <typename T>
+void BasicQRDecomposition<T>::apply_reflectors(std::vector<T>& b,
+                                               bool transpose) const {
+  const size_t m = rows();
+  for (size_t step = 0; step < steps(); ++step) {
+    const size_t k = transpose ? step : steps() - 1 - step;
+    if (tau_[k] == T(0)) {
+      continue;
+    }
+    T dot = b[k];
+    for (size_t i = k + 1; i < m; ++i) {
+      dot += qr_(i, k) * b[i];
+    }
+    dot *= tau_[k];
+    b[k] -= dot;
+    for (size_t i = k + 1; i < m; ++i) {
+      b[i] -= dot * qr_(i, k);
+    }
+  }
+}
+
+template <typename T>
+BasicMatrix<T> BasicQRDecomposition<T>::q() const {
+  BasicMatrix<T> result(rows(), steps());
+  std::vector<T> column(rows());
+  for (size_t j = 0; j < steps(); ++j) {
+    std::fill(column.begin(), column.end(), T(0));
+    column[j] = T(1);
+    apply_reflectors(column, false);
+    for (size_t i = 0; i < rows(); ++i) {
+      result(i, j) = std::move(column[i]);
+    }
+  }
+  return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicQRDecomposition<T>::r() const {
+  BasicMatrix<T> result(steps(), cols());
+  for (size_t i = 0; i < steps(); ++i) {
+    std::copy(qr_.row_data(i) + i, qr_.row_data(i) + cols(),
+              result.row_data(i) + i);
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<BasicVector<T>> BasicQRDecomposition<T>::orthonormal_basis()
+    const {
+  std::vector<BasicVector<T>> result;
+  result.reserve(rank_);
+  std::vector<T> column(rows());
+  for (size_t j = 0; j < rank_; ++j) {
+    std::fill(column.begin(), column.end(), T(0));
+    column[j] = T(1);
+    apply_reflectors(column, false);
+    result.emplace_back(column);
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<T> BasicQRDecomposition<T>::solve(const std::vector<T>& b) const {
+  if (b.size() != rows()) {
+    throw std::runtime_error("Matrix size mismatch in operation: qr_solve");
+  }
+  if (rank_ < cols() && !pivoted_) {
+    throw std::runtime_error("No unique solution in operation: qr_solve");
+  }
+
+  std::vector<T> c = b;
+  apply_reflectors(c, true);
+  std::vector<T> y(rank_);
+  for (size_t i = rank_; i-- > 0;) {
+    T sum = c[i];
+    for (size_t j = i + 1; j < rank_; ++j) {
+      sum -= qr_(i, j) * y[j];
+    }
+    y[i] = sum / qr_(i, i);
+  }
+
+  std::vector<T> x(cols(), T(0));
+  for (size_t j = 0; j < rank_; ++j) {
+    x[perm_[j]] = std::move(y[j]);
+  }
+  return x;
+}
+
+// Modified Gram-Schmidt, run twice per vector ("twice is enough"): the
+// second pass removes what rounding left of the earlier directions. A
+// vector whose remainder is below tolerance times its own norm depends on
+// the earlier ones and is dropped, so the result is an orthonormal basis of
+// the span. Exact scalars use EPS for the square roots and keep entries to
+// EPS plus guard digits.
+template <typename T>
+std::vector<BasicVector<T>> gram_schmidt_process(
+    const std::vector<BasicVector<T>>& vectors,
+    const T& EPS = scalar_traits<T>::epsilon()) {
+  using traits = scalar_traits<T>;
+  constexpr size_t kGuardDigits = 10;
+  const size_t digits = traits::decimal_places(EPS) + kGuardDigits;
+  const T relative = traits::exact ? EPS * T(1000) : traits::tolerance();
+
+  std::vector<BasicVector<T>> basis;
+  for (const auto& vector : vectors) {
+    if (!basis.empty() && vector.dimension() != basis[0].dimension()) {
+      throw std::invalid_argument(
+          "gram_schmidt_process - dimension mismatch: " +
+          std::to_string(vector.dimension()) +
+          " != " + std::to_string(basis[0].dimension()));
+    }
+    const T original = traits::sqrt(vector.dot(vector), EPS);
+    if (original == T(0)) {
+      continue;
+    }
+    std::vector<T> u = vector.components();
+    for (size_t pass = 0; pass < 2; ++pass) {
+      for (const auto& q : basis) {
+        T projection(0);
+        for (size_t i = 0; i < u.size(); ++i) {
+          projection += q(i) * u[i];
+        }
+        subtract_scaled(u.data(), q.components().data(), projection,
+                        u.size());
+      }
+      if constexpr (traits::exact) {
+        for (auto& value : u) {
+          value = traits::rounded(value, digits);
+        }
+      }
+    }
+
+    T norm(0);
+    for (const auto& value : u) {
+      norm += value * value;
+    }
+    norm = traits::sqrt(norm, EPS);
+    if (norm <= relative * original) {
+      continue;
+    }
+    for (auto& value : u) {
+      value = traits::rounded(value / norm, digits);
+    }
+    basis.emplace_back(u);
+  }
+  return basis;
+}
+
+extern template class BasicQRDecomposition<bigfloat>;
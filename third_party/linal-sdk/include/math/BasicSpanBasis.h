@@ -0,0 +1,250 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicVector.h"
+#include "scalar_traits.h"
+#include "simd_kernels.h"
+
+// A basis of the span of a stream of vectors, kept up to date one vector at
+// a time instead of re-eliminating everything on each query. SpanBasis and
+// SpanBasisBF are the double and bigfloat instances.
+//
+// The span is held in reduced row echelon form: echelon row k is 1 at
+// column pivot_[k] and 0 at every other pivot column. The coefficient of
+// row k in any vector of the span is then just its pivot_[k] entry, so
+// contains() and coefficients() cost O(n r), and so does insert(), which
+// additionally clears the new pivot column from the r existing rows.
+//
+// Only vectors that enlarge the span are kept, in insertion order, as
+// vectors(); transform_ writes every echelon row as a combination of them,
+// so coefficients() can answer in terms of the vectors the caller inserted
+// and remove() can drop one of them again in O(n r).
+//
+// Rounded scalars treat residual entries below traits::tolerance(), scaled
+// by the largest entry of the vector, as zero; exact scalars test for zero.
+template <typename T>
+class BasicSpanBasis {
+ private:
+  using traits = scalar_traits<T>;
+
+  size_t dimension_{};
+  std::vector<std::vector<T>> vectors_;
+  std::vector<std::vector<T>> echelon_;
+  std::vector<size_t> pivot_;
+  // echelon_[k] = sum over j of transform_[k][j] * vectors_[j].
+  std::vector<std::vector<T>> transform_;
+
+  void check_dimension(size_t size, const std::string& op) const {
+    if (size != dimension_) {
+      throw std::invalid_argument(
+          "SpanBasis::" + op + " - dimension mismatch: " +
+          std::to_string(size) + " != " + std::to_string(dimension_));
+    }
+  }
+
+  T zero_threshold(const std::vector<T>& vector) const;
+
+  // vector - sum of coefficients[k] * echelon_[k], with coefficients[k] the
+  // pivot entries of `vector`.
+  std::vector<T> reduce(const std::vector<T>& vector,
+                        std::vector<T>& coefficients) const;
+
+ public:
+  using value_type = T;
+
+  BasicSpanBasis() = default;
+  explicit BasicSpanBasis(size_t dimension) : dimension_(dimension) {}
+
+  size_t dimension() const noexcept { return dimension_; }
+  size_t span_dimension() const noexcept { return vectors_.size(); }
+  const std::vector<std::vector<T>>& vectors() const noexcept {
+    return vectors_;
+  }
+
+  // Adds `vector` if it is not already in the span; returns whether it was.
+  bool insert(const std::vector<T>& vector);
+  bool insert(const BasicVector<T>& vector) {
+    return insert(vector.components());
+  }
+
+  bool contains(const std::vector<T>& vector) const {
+    return coefficients(vector).has_value();
+  }
+  bool contains(const BasicVector<T>& vector) const {
+    return contains(vector.components());
+  }
+
+  // c with vector = sum of c[j] * vectors()[j], or std::nullopt when
+  // `vector` is outside the span.
+  std::optional<std::vector<T>> coefficients(
+      const std::vector<T>& vector) const;
+  std::optional<std::vector<T>> coefficients(
+      const BasicVector<T>& vector) const {
+    return coefficients(vector.components());
+  }
+
+  // Drops vectors()[index]; the span shrinks by one dimension.
+  void remove(size_t index);
+};
+
+template <typename T>
+T BasicSpanBasis<T>::zero_threshold(const std::vector<T>& vector) const {
+  if constexpr (traits::exact) {
+    return T(0);
+  } else {
+    T scale(1);
+    for (const auto& value : vector) {
+      if (traits::abs(value) > scale) {
+        scale = traits::abs(value);
+      }
+    }
+    return traits::tolerance() * scale;
+  }
+}
+
+template <typename T>
+std::vector<T> BasicSpanBasis<T>::reduce(const std::vector<T>& vector,
+                                         std::vector<T>& coefficients) const {
+  std::vector<T> residual = vector;
+  coefficients.assign(echelon_.size(), T(0));
+  for (size_t k = 0; k < echelon_.size(); ++k) {
+    coefficients[k] = vector[pivot_[k]];
+    if (coefficients[k] != T(0)) {
+      subtract_scaled(residual.data(), echelon_[k].data(), coefficients[k],
+                      dimension_);
+    }
+  }
+  return residual;
+}
+
+template <typename T>
+bool BasicSpanBasis<T>::insert(const std::vector<T>& vector) {
+  check_dimension(vector.size(), "insert");
+  std::vector<T> coefficients;
+  std::vector<T> residual = reduce(vector, coefficients);
+
+  const T threshold = zero_threshold(vector);
+  size_t pivot = dimension_;
+  T best(0);
+  for (size_t col = 0; col < dimension_; ++col) {
+    T candidate = traits::abs(residual[col]);
+    if (candidate > threshold && candidate > best) {
+      best = std::move(candidate);
+      pivot = col;
+      if constexpr (!traits::partial_pivoting) {
+        break;
+      }
+    }
+  }
+  if (pivot == dimension_) {
+    return false;
+  }
+
+  // residual = vector - sum of coefficients[k] * echelon_[k], so in terms
+  // of vectors_ it is e_r - sum of coefficients[k] * transform_[k].
+  const size_t r = vectors_.size();
+  std::vector<T> transform(r + 1, T(0));
+  transform[r] = T(1);
+  for (size_t k = 0; k < r; ++k) {
+    transform_[k].push_back(T(0));
+    if (coefficients[k] != T(0)) {
+      subtract_scaled(transform.data(), transform_[k].data(), coefficients[k],
+                      r);
+    }
+  }
+
+  const T scale = residual[pivot];
+  for (auto& value : residual) {
+    value /= scale;
+  }
+  for (auto& value : transform) {
+    value /= scale;
+  }
+  residual[pivot] = T(1);
+
+  for (size_t k = 0; k < r; ++k) {
+    const T factor = echelon_[k][pivot];
+    if (factor != T(0)) {
+      subtract_scaled(echelon_[k].data(), residual.data(), factor, dimension_);
+      subtract_scaled(transform_[k].data(), transform.data(), factor, r + 1);
+      echelon_[k][pivot] = T(0);
+    }
+  }
+
+  vectors_.push_back(vector);
+  echelon_.push_back(std::move(residual));
+  pivot_.push_back(pivot);
+  transform_.push_back(std::move(transform));
+  return true;
+}
+
+template <typename T>
+std::optional<std::vector<T>> BasicSpanBasis<T>::coefficients(
+    const std::vector<T>& vector) const {
+  check_dimension(vector.size(), "coefficients");
+  std::vector<T> echelon_coefficients;
+  const std::vector<T> residual = reduce(vector, echelon_coefficients);
+  const T threshold = zero_threshold(vector);
+  for (const auto& value : residual) {
+    if (traits::abs(value) > threshold) {
+      return std::nullopt;
+    }
+  }
+
+  std::vector<T> result(vectors_.size(), T(0));
+  for (size_t k = 0; k < echelon_.size(); ++k) {
+    if (echelon_coefficients[k] != T(0)) {
+      subtract_scaled(result.data(), transform_[k].data(),
+                      -echelon_coefficients[k], result.size());
+    }
+  }
+  return result;
+}
+
+// Every echelon row with a nonzero weight on vectors_[index] except the
+// heaviest one is cleared of it using that row, which is then dropped. The
+// remaining rows combine only the other vectors and keep their own pivots:
+// the dropped row was 0 at all of them.
+template <typename T>
+void BasicSpanBasis<T>::remove(size_t index) {
+  if (index >= vectors_.size()) {
+    throw std::out_of_range("Span basis index out of range");
+  }
+  size_t drop = 0;
+  T best(0);
+  for (size_t k = 0; k < transform_.size(); ++k) {
+    T candidate = traits::abs(transform_[k][index]);
+    if (candidate > best) {
+      best = std::move(candidate);
+      drop = k;
+    }
+  }
+
+  const T pivot = transform_[drop][index];
+  for (size_t k = 0; k < transform_.size(); ++k) {
+    if (k == drop || transform_[k][index] == T(0)) {
+      continue;
+    }
+    const T factor = transform_[k][index] / pivot;
+    subtract_scaled(echelon_[k].data(), echelon_[drop].data(), factor,
+                    dimension_);
+    subtract_scaled(transform_[k].data(), transform_[drop].data(), factor,
+                    vectors_.size());
+  }
+
+  echelon_.erase(echelon_.begin() + drop);
+  pivot_.erase(pivot_.begin() + drop);
+  transform_.erase(transform_.begin() + drop);
+  for (auto& row : transform_) {
+    row.erase(row.begin() + index);
+  }
+  vectors_.erase(vectors_.begin() + index);
+}
+
+extern template class BasicSpanBasis<bigfloat>;
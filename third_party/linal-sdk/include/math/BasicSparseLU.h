@@ -0,0 +1,286 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicSparseMatrix.h"
+#include "scalar_traits.h"
+
+// Sparse LU with column ordering and row pivoting: P A Q = L U, left-looking
+// (Gilbert-Peierls). Column k of L and U comes from one sparse triangular
+// solve whose nonzero pattern is found by a depth-first search through the
+// columns of L computed so far, so the work is proportional to the
+// arithmetic actually done, not to the matrix size.
+//
+// Columns are taken in BasicSparseMatrix::fill_reducing_order(). Rounded
+// scalars use threshold partial pivoting, keeping the diagonal when it is
+// within kPivotThreshold of the largest candidate; exact scalars keep the
+// diagonal whenever it is nonzero. A column with no usable pivot (only
+// zeros, or only entries below traits::tolerance() for rounded scalars) is
+// linearly dependent on the earlier ones and is skipped, so rank() works for
+// any rectangular matrix. solve() and determinant() need a nonsingular
+// square matrix.
+template <typename T>
+class BasicSparseLU {
+ private:
+  using traits = scalar_traits<T>;
+
+  static constexpr size_t kNone = std::numeric_limits<size_t>::max();
+  static constexpr double kPivotThreshold = 0.1;
+
+  size_t rows_{}, cols_{};
+  // Step k pivots column pivot_col_[k] on row pivot_row_[k].
+  std::vector<size_t> pivot_row_;
+  std::vector<size_t> pivot_col_;
+  std::vector<size_t> row_step_;
+  // l_[k]: (row, value) below the unit diagonal of column k of L, rows in
+  // the original numbering. u_[k]: (step, value) above the diagonal of
+  // column k of U.
+  std::vector<std::vector<std::pair<size_t, T>>> l_;
+  std::vector<std::vector<std::pair<size_t, T>>> u_;
+  std::vector<T> diagonal_;
+
+  size_t choose_pivot(const std::vector<size_t>& candidates,
+                      const std::vector<T>& work, size_t col) const;
+
+ public:
+  explicit BasicSparseLU(const BasicSparseMatrix<T>& matrix,
+                         bool reorder = true);
+
+  size_t rows() const noexcept { return rows_; }
+  size_t cols() const noexcept { return cols_; }
+  size_t rank() const noexcept { return diagonal_.size(); }
+  bool is_singular() const noexcept {
+    return rows_ != cols_ || rank() != cols_;
+  }
+  // Nonzeros stored in L and U together, diagonals included.
+  size_t fill() const;
+
+  std::vector<T> solve(const std::vector<T>& b) const;
+  T determinant() const;
+};
+
+template <typename T>
+BasicSparseLU<T>::BasicSparseLU(const BasicSparseMatrix<T>& matrix,
+                                bool reorder)
+    : rows_(matrix.rows()), cols_(matrix.cols()), row_step_(rows_, kNone) {
+  const BasicSparseMatrix<T> columns = matrix.transpose();
+  std::vector<size_t> order(cols_);
+  if (reorder) {
+    order = matrix.fill_reducing_order();
+  } else {
+    std::iota(order.begin(), order.end(), 0);
+  }
+
+  std::vector<T> work(rows_);
+  std::vector<char> visited(rows_, 0);
+  std::vector<size_t> touched;
+  std::vector<size_t> candidates;
+  std::vector<size_t> topological;
+  std::vector<std::pair<size_t, size_t>> stack;
+
+  for (size_t col : order) {
+    touched.clear();
+    candidates.clear();
+    topological.clear();
+
+    const size_t first = columns.row_start()[col];
+    const size_t last = columns.row_start()[col + 1];
+    for (size_t k = first; k < last; ++k) {
+      work[columns.col_index()[k]] = columns.values()[k];
+    }
+
+    // Rows reachable from the column through L: pivotal ones in reverse
+    // topological order, the others are pivot candidates.
+    auto visit = [&](size_t row) {
+      visited[row] = 1;
+      touched.push_back(row);
+      if (row_step_[row] == kNone) {
+        candidates.push_back(row);
+      } else {
+        stack.emplace_back(row, 0);
+      }
+    };
+    for (size_t k = first; k < last; ++k) {
+      const size_t root = columns.col_index()[k];
+      if (visited[root]) {
+        continue;
+      }
+      visit(root);
+      while (!stack.empty()) {
+        const size_t step = row_step_[stack.back().first];
+        const size_t next = stack.back().second;
+        if (next < l_[step].size()) {
+          ++stack.back().second;
+          const size_t child = l_[step][next].first;
+          if (!visited[child]) {
+            visit(child);
+          }
+        } else {
+          topological.push_back(step);
+          stack.pop_back();
+        }
+      }
+    }
+
+    std::vector<std::pair<size_t, T>> u_column;
+    for (size_t i = topological.size(); i-- > 0;) {
+      const size_t step = topological[i];
+      const T x = work[pivot_row_[step]];
+      if (x == T(0)) {
+        continue;
+      }
+      for (const auto& [row, value] : l_[step]) {
+        work[row] -= value * x;
+      }
+      u_column.emplace_back(step, x);
+    }
+
+    const size_t pivot = choose_pivot(candidates, work, col);
+    if (pivot != kNone) {
+      const T& diagonal = work[pivot];
+      std::vector<std::pair<size_t, T>> l_column;
+      for (size_t row : candidates) {
+        if (row != pivot && work[row] != T(0)) {
+          l_column.emplace_back(row, work[row] / diagonal);
+        }
+      }
+      row_step_[pivot] = pivot_row_.size();
+      pivot_row_.push_back(pivot);
+      pivot_col_.push_back(col);
+      diagonal_.push_back(diagonal);
+      l_.push_back(std::move(l_column));
+      u_.push_back(std::move(u_column));
+    }
+
+    for (size_t row : touched) {
+      work[row] = T(0);
+      visited[row] = 0;
+    }
+  }
+}
+
+template <typename T>
+size_t BasicSparseLU<T>::choose_pivot(const std::vector<size_t>& candidates,
+                                      const std::vector<T>& work,
+                                      size_t col) const {
+  const bool has_diagonal = col < rows_ && row_step_[col] == kNone;
+  if constexpr (traits::exact) {
+    if (has_diagonal && work[col] != T(0)) {
+      return col;
+    }
+    size_t pivot = kNone;
+    for (size_t row : candidates) {
+      if (work[row] != T(0) && (pivot == kNone || row < pivot)) {
+        pivot = row;
+      }
+    }
+    return pivot;
+  } else {
+    size_t pivot = kNone;
+    T best(0);
+    for (size_t row : candidates) {
+      T magnitude = traits::abs(work[row]);
+      if (magnitude > best) {
+        best = std::move(magnitude);
+        pivot = row;
+      }
+    }
+    if (pivot == kNone || best <= traits::tolerance()) {
+      return kNone;
+    }
+    if (has_diagonal &&
+        traits::abs(work[col]) >= T(kPivotThreshold) * best) {
+      return col;
+    }
+    return pivot;
+  }
+}
+
+template <typename T>
+size_t BasicSparseLU<T>::fill() const {
+  size_t count = diagonal_.size();
+  for (size_t k = 0; k < diagonal_.size(); ++k) {
+    count += l_[k].size() + u_[k].size();
+  }
+  return count;
+}
+
+// With w = U Q^T x, L w = P b is solved column by column in pivot order,
+// then U z = w backwards, and x[pivot_col_[k]] = z[k].
+template <typename T>
+std::vector<T> BasicSparseLU<T>::solve(const std::vector<T>& b) const {
+  if (b.size() != rows_) {
+    throw std::runtime_error("Matrix size mismatch in operation: solve");
+  }
+  if (is_singular()) {
+    throw std::runtime_error("No unique solution in operation: solve");
+  }
+  const size_t n = rank();
+
+  std::vector<T> residual = b;
+  std::vector<T> w(n);
+  for (size_t k = 0; k < n; ++k) {
+    w[k] = residual[pivot_row_[k]];
+    if (w[k] == T(0)) {
+      continue;
+    }
+    for (const auto& [row, value] : l_[k]) {
+      residual[row] -= value * w[k];
+    }
+  }
+
+  std::vector<T> x(cols_);
+  for (size_t k = n; k-- > 0;) {
+    T z = w[k] / diagonal_[k];
+    if (z != T(0)) {
+      for (const auto& [step, value] : u_[k]) {
+        w[step] -= value * z;
+      }
+    }
+    x[pivot_col_[k]] = std::move(z);
+  }
+  return x;
+}
+
+template <typename T>
+T BasicSparseLU<T>::determinant() const {
+  if (rows_ != cols_) {
+    throw std::runtime_error("Matrix must be square for operation: determinant");
+  }
+  if (is_singular()) {
+    return T(0);
+  }
+
+  // det(A) = sign(P) sign(Q) prod(diagonal); each permutation's sign comes
+  // from its cycle count.
+  auto odd = [](const std::vector<size_t>& permutation) {
+    std::vector<char> seen(permutation.size(), 0);
+    bool parity = false;
+    for (size_t start = 0; start < permutation.size(); ++start) {
+      if (seen[start]) {
+        continue;
+      }
+      size_t length = 0;
+      for (size_t i = start; !seen[i]; i = permutation[i]) {
+        seen[i] = 1;
+        ++length;
+      }
+      parity ^= (length % 2 == 0);
+    }
+    return parity;
+  };
+
+  T det(1);
+  for (const auto& value : diagonal_) {
+    det *= value;
+  }
+  return odd(pivot_row_) != odd(pivot_col_) ? -det : det;
+}
+
+extern template class BasicSparseLU<bigfloat>;
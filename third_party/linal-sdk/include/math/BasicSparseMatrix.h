@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "BasicMatrix.h"
+#include "scalar_traits.h"
+#include "sparse_ordering.h"
+
+template <typename T>
+struct SparseEntry {
+  size_t row;
+  size_t col;
+  T value;
+};
+
+// Compressed sparse row matrix over any scalar with a scalar_traits
+// specialization; SparseMatrix and SparseMatrixBF are the double and
+// bigfloat instances. Only nonzeros are stored, so memory and every
+// operation scale with nonzeros() rather than rows() * cols().
+//
+// CSC is the same layout read by columns: transpose() returns the CSR form
+// of the transpose, whose rows are the columns of *this. BasicSparseLU uses
+// it for column access.
+template <typename T>
+class BasicSparseMatrix {
+ private:
+  using traits = scalar_traits<T>;
+
+  size_t rows_{}, cols_{};
+  // Row i owns col_index_ and values_ in [row_start_[i], row_start_[i + 1]),
+  // columns strictly ascending, no explicit zeros.
+  std::vector<size_t> row_start_;
+  std::vector<size_t> col_index_;
+  std::vector<T> values_;
+
+  void check_operand(size_t size, size_t expected,
+                     const std::string& op) const {
+    if (size != expected) {
+      throw std::runtime_error("Matrix size mismatch in operation: " + op);
+    }
+  }
+
+ public:
+  using value_type = T;
+
+  BasicSparseMatrix() : row_start_(1, 0) {}
+  BasicSparseMatrix(size_t rows, size_t cols)
+      : rows_(rows), cols_(cols), row_start_(rows + 1, 0) {}
+  // Entries at the same position are summed; zero sums are dropped.
+  BasicSparseMatrix(size_t rows, size_t cols,
+                    std::vector<SparseEntry<T>> entries);
+  explicit BasicSparseMatrix(const BasicMatrix<T>& dense);
+  // One row per inner vector, like BasicMatrix.
+  explicit BasicSparseMatrix(const std::vector<std::vector<T>>& rows);
+
+  size_t rows() const noexcept { return rows_; }
+  size_t cols() const noexcept { return cols_; }
+  size_t nonzeros() const noexcept { return values_.size(); }
+
+  const std::vector<size_t>& row_start() const noexcept { return row_start_; }
+  const std::vector<size_t>& col_index() const noexcept { return col_index_; }
+  const std::vector<T>& values() const noexcept { return values_; }
+
+  // Zero for positions that are not stored.
+  T at(size_t row, size_t col) const;
+
+  // Adds a row at the bottom; amortised O(nonzeros of the row).
+  void append_row(const std::vector<T>& row);
+
+  BasicSparseMatrix transpose() const;
+  BasicMatrix<T> to_dense() const;
+
+  // y = A x and y = A^T x, O(nonzeros()).
+  std::vector<T> multiply(const std::vector<T>& x) const;
+  std::vector<T> multiply_transposed(const std::vector<T>& x) const;
+
+  // Column order for BasicSparseLU: minimum degree on the pattern of
+  // A + A^T for square matrices and of A^T A otherwise. Rows with more than
+  // 10 sqrt(cols()) nonzeros are left out of A^T A, they would turn it into
+  // one dense clique without changing the best order much.
+  std::vector<size_t> fill_reducing_order() const;
+};
+
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix(size_t rows, size_t cols,
+                                        std::vector<SparseEntry<T>> entries)
+    : rows_(rows), cols_(cols), row_start_(rows + 1, 0) {
+  for (const auto& entry : entries) {
+    if (entry.row >= rows_ || entry.col >= cols_) {
+      throw std::out_of_range("Matrix index out of range");
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const SparseEntry<T>& a, const SparseEntry<T>& b) {
+              return a.row != b.row ? a.row < b.row : a.col < b.col;
+            });
+
+  for (size_t i = 0; i < entries.size();) {
+    size_t j = i + 1;
+    T sum = std::move(entries[i].value);
+    while (j < entries.size() && entries[j].row == entries[i].row &&
+           entries[j].col == entries[i].col) {
+      sum += entries[j++].value;
+    }
+    if (sum != T(0)) {
+      col_index_.push_back(entries[i].col);
+      values_.push_back(std::move(sum));
+      ++row_start_[entries[i].row + 1];
+    }
+    i = j;
+  }
+  std::partial_sum(row_start_.begin(), row_start_.end(), row_start_.begin());
+}
+
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix(const BasicMatrix<T>& dense)
+    : BasicSparseMatrix(0, dense.cols()) {
+  for (size_t i = 0; i < dense.rows(); ++i) {
+    append_row(std::vector<T>(dense.row_data(i),
+                              dense.row_data(i) + dense.cols()));
+  }
+}
+
+template <typename T>
+BasicSparseMatrix<T>::BasicSparseMatrix(const std::vector<std::vector<T>>& rows)
+    : BasicSparseMatrix(0, rows.empty() ? 0 : rows[0].size()) {
+  for (const auto& row : rows) {
+    if (row.size() != cols_) {
+      throw std::runtime_error("Inconsistent row sizes in matrix");
+    }
+    append_row(row);
+  }
+}
+
+template <typename T>
+T BasicSparseMatrix<T>::at(size_t row, size_t col) const {
+  if (row >= rows_ || col >= cols_) {
+    throw std::out_of_range("Matrix index out of range");
+  }
+  const auto first = col_index_.begin() + row_start_[row];
+  const auto last = col_index_.begin() + row_start_[row + 1];
+  const auto found = std::lower_bound(first, last, col);
+  if (found == last || *found != col) {
+    return T(0);
+  }
+  return values_[found - col_index_.begin()];
+}
+
+template <typename T>
+void BasicSparseMatrix<T>::append_row(const std::vector<T>& row) {
+  check_operand(row.size(), cols_, "append_row");
+  for (size_t j = 0; j < cols_; ++j) {
+    if (row[j] != T(0)) {
+      col_index_.push_back(j);
+      values_.push_back(row[j]);
+    }
+  }
+  row_start_.push_back(values_.size());
+  ++rows_;
+}
+
+// Counting sort by column: one pass to size the rows of the result, one to
+// fill them. Rows are visited in order, so columns stay sorted.
+template <typename T>
+BasicSparseMatrix<T> BasicSparseMatrix<T>::transpose() const {
+  BasicSparseMatrix result(cols_, rows_);
+  for (size_t col : col_index_) {
+    ++result.row_start_[col + 1];
+  }
+  std::partial_sum(result.row_start_.begin(), result.row_start_.end(),
+                   result.row_start_.begin());
+
+  result.col_index_.resize(nonzeros());
+  result.values_.resize(nonzeros());
+  std::vector<size_t> next(result.row_start_.begin(),
+                           result.row_start_.end() - 1);
+  for (size_t i = 0; i < rows_; ++i) {
+    for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+      const size_t slot = next[col_index_[k]]++;
+      result.col_index_[slot] = i;
+      result.values_[slot] = values_[k];
+    }
+  }
+  return result;
+}
+
+template <typename T>
+BasicMatrix<T> BasicSparseMatrix<T>::to_dense() const {
+  BasicMatrix<T> result(rows_, cols_);
+  for (size_t i = 0; i < rows_; ++i) {
+    for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+      result(i, col_index_[k]) = values_[k];
+    }
+  }
+  return result;
+}
+
+template <typename T>
+std::vector<T> BasicSparseMatrix<T>::multiply(const std::vector<T>& x) const {
+  check_operand(x.size(), cols_, "multiply");
+  std::vector<T> y(rows_);
+  for (size_t i = 0; i < rows_; ++i) {
+    T sum(0);
+    for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+      sum += values_[k] * x[col_index_[k]];
+    }
+    y[i] = std::move(sum);
+  }
+  return y;
+}
+
+template <typename T>
+std::vector<T> BasicSparseMatrix<T>::multiply_transposed(
+    const std::vector<T>& x) const {
+  check_operand(x.size(), rows_, "multiply_transposed");
+  std::vector<T> y(cols_);
+  for (size_t i = 0; i < rows_; ++i) {
+    if (x[i] == T(0)) {
+      continue;
+    }
+    for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+      y[col_index_[k]] += values_[k] * x[i];
+    }
+  }
+  return y;
+}
+
+template <typename T>
+std::vector<size_t> BasicSparseMatrix<T>::fill_reducing_order() const {
+  std::vector<std::vector<size_t>> adjacency(cols_);
+  if (rows_ == cols_) {
+    for (size_t i = 0; i < rows_; ++i) {
+      for (size_t k = row_start_[i]; k < row_start_[i + 1]; ++k) {
+        adjacency[i].push_back(col_index_[k]);
+      }
+    }
+  } else {
+    const auto dense_row = static_cast<size_t>(
+        10.0 * std::sqrt(static_cast<double>(cols_)));
+    for (size_t i = 0; i < rows_; ++i) {
+      const size_t first = row_start_[i];
+      const size_t last = row_start_[i + 1];
+      if (last - first > dense_row) {
+        continue;
+      }
+      for (size_t k = first; k < last; ++k) {
+        adjacency[col_index_[k]].insert(adjacency[col_index_[k]].end(),
+                                        col_index_.begin() + first,
+                                        col_index_.begin() + last);
+      }
+    }
+  }
+  return minimum_degree_ordering(std::move(adjacency));
+}
+
+extern template class BasicSparseMatrix<bigfloat>;
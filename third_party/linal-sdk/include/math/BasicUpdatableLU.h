@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicLUDecomposition.h"
+#include "BasicMatrix.h"
+#include "scalar_traits.h"
+#include "simd_kernels.h"
+
+// A factorization that follows a matrix through low-rank changes without
+// refactoring it: after updates A = A0 + U V^T, with A0 factored once and
+// U, V of width k, the Sherman-Morrison-Woodbury identity gives
+//
+//   A^-1 b = y - Z C^-1 V^T y,  y = A0^-1 b,  Z = A0^-1 U,  C = I + V^T Z.
+//
+// A rank-1 update, row replacement or column replacement costs one solve
+// with A0 plus O(n k + k^3) to extend Z and refactor the k x k capacitance
+// matrix C, so O(n^2) for small k; a solve costs O(n^2 + n k). UpdatableLU
+// and UpdatableLUBF are the double and bigfloat instances.
+//
+// Every update is checked, and A is refactored from scratch (resetting k to
+// zero) when
+//   - k would exceed max_rank(), beyond which solves cost more than a
+//     fresh factorization saves,
+//   - C is singular, or for rounded scalars C.pivot_ratio() drops below
+//     kMinPivotRatio, so the correction would amplify rounding error,
+//   - A0 itself is singular and Woodbury does not apply.
+// A is kept explicitly, so refactoring needs nothing from the caller.
+template <typename T>
+class BasicUpdatableLU {
+ private:
+  using traits = scalar_traits<T>;
+
+  static constexpr double kMinPivotRatio = 1e-8;
+  static constexpr size_t kDefaultMaxRank = 16;
+
+  BasicMatrix<T> matrix_;
+  BasicLUDecomposition<T> base_;
+  size_t max_rank_{};
+  size_t refactorizations_{};
+  // Column j of U, V and Z = A0^-1 U.
+  std::vector<std::vector<T>> u_;
+  std::vector<std::vector<T>> v_;
+  std::vector<std::vector<T>> z_;
+  BasicMatrix<T> capacitance_;
+  BasicLUDecomposition<T> capacitance_lu_;
+
+  void check_size(size_t size, const std::string& op) const {
+    if (size != matrix_.rows()) {
+      throw std::runtime_error("Matrix size mismatch in operation: " + op);
+    }
+  }
+
+  void refactor();
+  // Records A += u v^T in U, V, Z and C without refactoring C.
+  bool append(std::vector<T> u, std::vector<T> v);
+  // Refactors C, or all of A if the checks above fail.
+  void settle(bool woodbury);
+
+ public:
+  BasicUpdatableLU() = default;
+  explicit BasicUpdatableLU(const BasicMatrix<T>& matrix,
+                            size_t max_rank = kDefaultMaxRank);
+
+  size_t size() const noexcept { return matrix_.rows(); }
+  const BasicMatrix<T>& matrix() const noexcept { return matrix_; }
+  // Width k of the pending correction; zero right after a refactor.
+  size_t update_rank() const noexcept { return u_.size(); }
+  size_t max_rank() const noexcept { return max_rank_; }
+  // Number of factorizations from scratch, the initial one included.
+  size_t refactorizations() const noexcept { return refactorizations_; }
+  bool is_singular() const;
+
+  // A += u v^T.
+  void update(const std::vector<T>& u, const std::vector<T>& v);
+  // A += U V^T for n x k matrices U and V.
+  void update(const BasicMatrix<T>& u, const BasicMatrix<T>& v);
+  void replace_row(size_t row, const std::vector<T>& values);
+  void replace_column(size_t col, const std::vector<T>& values);
+
+  std::vector<T> solve(const std::vector<T>& b) const;
+  // det A = det A0 det C.
+  T determinant() const;
+  BasicMatrix<T> inverse() const;
+};
+
+template <typename T>
+BasicUpdatableLU<T>::BasicUpdatableLU(const BasicMatrix<T>& matrix,
+                                      size_t max_rank)
+    : matrix_(matrix), max_rank_(max_rank) {
+  if (matrix.rows() != matrix.cols()) {
+    throw std::runtime_error(
+        "Matrix must be square for operation: updatable_lu");
+  }
+  refactor();
+}
+
+template <typename T>
+void BasicUpdatableLU<T>::refactor() {
+  base_ = BasicLUDecomposition<T>(matrix_);
+  u_.clear();
+  v_.clear();
+  z_.clear();
+  capacitance_ = BasicMatrix<T>();
+  capacitance_lu_ = BasicLUDecomposition<T>();
+  ++refactorizations_;
+}
+
+template <typename T>
+bool BasicUpdatableLU<T>::append(std::vector<T> u, std::vector<T> v) {
+  const size_t n = size();
+  for (size_t i = 0; i < n; ++i) {
+    if (u[i] != T(0)) {
+      subtract_scaled(matrix_.row_data(i), v.data(), -u[i], n);
+    }
+  }
+  if (base_.is_singular() || u_.size() >= max_rank_) {
+    return false;
+  }
+
+  std::vector<T> z = base_.solve(u);
+  const size_t k = u_.size();
+  BasicMatrix<T> capacitance(k + 1, k + 1);
+  for (size_t i = 0; i < k; ++i) {
+    std::copy(capacitance_.row_data(i), capacitance_.row_data(i) + k,
+              capacitance.row_data(i));
+  }
+  for (size_t i = 0; i < k; ++i) {
+    T row_sum(0), col_sum(0);
+    for (size_t l = 0; l < n; ++l) {
+      row_sum += v[l] * z_[i][l];
+      col_sum += v_[i][l] * z[l];
+    }
+    capacitance(k, i) = std::move(row_sum);
+    capacitance(i, k) = std::move(col_sum);
+  }
+  T diagonal(1);
+  for (size_t l = 0; l < n; ++l) {
+    diagonal += v[l] * z[l];
+  }
+  capacitance(k, k) = std::move(diagonal);
+
+  capacitance_ = std::move(capacitance);
+  u_.push_back(std::move(u));
+  v_.push_back(std::move(v));
+  z_.push_back(std::move(z));
+  return true;
+}
+
+template <typename T>
+void BasicUpdatableLU<T>::settle(bool woodbury) {
+  if (woodbury) {
+    capacitance_lu_ = BasicLUDecomposition<T>(capacitance_);
+    woodbury = !capacitance_lu_.is_singular();
+    if constexpr (!traits::exact) {
+      woodbury = woodbury && capacitance_lu_.pivot_ratio() >= kMinPivotRatio;
+    }
+  }
+  if (!woodbury) {
+    refactor();
+  }
+}
+
+template <typename T>
+bool BasicUpdatableLU<T>::is_singular() const {
+  return base_.is_singular() ||
+         (!u_.empty() && capacitance_lu_.is_singular());
+}
+
+template <typename T>
+void BasicUpdatableLU<T>::update(const std::vector<T>& u,
+                                 const std::vector<T>& v) {
+  check_size(u.size(), "update");
+  check_size(v.size(), "update");
+  settle(append(u, v));
+}
+
+template <typename T>
+void BasicUpdatableLU<T>::update(const BasicMatrix<T>& u,
+                                 const BasicMatrix<T>& v) {
+  check_size(u.rows(), "update");
+  check_size(v.rows(), "update");
+  if (u.cols() != v.cols()) {
+    throw std::runtime_error("Matrix size mismatch in operation: update");
+  }
+  bool woodbury = true;
+  for (size_t j = 0; j < u.cols(); ++j) {
+    std::vector<T> u_col(size()), v_col(size());
+    for (size_t i = 0; i < size(); ++i) {
+      u_col[i] = u(i, j);
+      v_col[i] = v(i, j);
+    }
+    woodbury = append(std::move(u_col), std::move(v_col)) && woodbury;
+  }
+  settle(woodbury);
+}
+
+template <typename T>
+void BasicUpdatableLU<T>::replace_row(size_t row,
+                                      const std::vector<T>& values) {
+  check_size(values.size(), "replace_row");
+  if (row >= size()) {
+    throw std::out_of_range("Matrix row index out of range");
+  }
+  std::vector<T> u(size(), T(0));
+  u[row] = T(1);
+  std::vector<T> v = values;
+  subtract_scaled(v.data(), matrix_.row_data(row), T(1), size());
+  settle(append(std::move(u), std::move(v)));
+}
+
+template <typename T>
+void BasicUpdatableLU<T>::replace_column(size_t col,
+                                         const std::vector<T>& values) {
+  check_size(values.size(), "replace_column");
+  if (col >= size()) {
+    throw std::out_of_range("Matrix column index out of range");
+  }
+  std::vector<T> u = values;
+  for (size_t i = 0; i < size(); ++i) {
+    u[i] -= matrix_(i, col);
+  }
+  std::vector<T> v(size(), T(0));
+  v[col] = T(1);
+  settle(append(std::move(u), std::move(v)));
+}
+
+template <typename T>
+std::vector<T> BasicUpdatableLU<T>::solve(const std::vector<T>& b) const {
+  check_size(b.size(), "solve");
+  std::vector<T> x = base_.solve(b);
+  if (u_.empty()) {
+    return x;
+  }
+  std::vector<T> w(u_.size(), T(0));
+  for (size_t j = 0; j < u_.size(); ++j) {
+    for (size_t i = 0; i < size(); ++i) {
+      w[j] += v_[j][i] * x[i];
+    }
+  }
+  const std::vector<T> s = capacitance_lu_.solve(w);
+  for (size_t j = 0; j < u_.size(); ++j) {
+    if (s[j] != T(0)) {
+      subtract_scaled(x.data(), z_[j].data(), s[j], size());
+    }
+  }
+  return x;
+}
+
+template <typename T>
+T BasicUpdatableLU<T>::determinant() const {
+  if (u_.empty()) {
+    return base_.determinant();
+  }
+  return base_.determinant() * capacitance_lu_.determinant();
+}
+
+template <typename T>
+BasicMatrix<T> BasicUpdatableLU<T>::inverse() const {
+  if (is_singular()) {
+    throw std::runtime_error("Singular matrix");
+  }
+  const size_t n = size();
+  BasicMatrix<T> result(n, n);
+  std::vector<T> e(n, T(0));
+  for (size_t j = 0; j < n; ++j) {
+    e[j] = T(1);
+    const std::vector<T> column = solve(e);
+    e[j] = T(0);
+    for (size_t i = 0; i < n; ++i) {
+      result(i, j) = column[i];
+    }
+  }
+  return result;
+}
+
+extern template class BasicUpdatableLU<bigfloat>;
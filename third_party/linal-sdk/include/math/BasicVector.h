@@ -0,0 +1,404 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "expression_templates.h"
+#include "robust_predicates.h"
+#include "scalar_traits.h"
+
+// Dense vector over any scalar with a scalar_traits specialization.
+// Vector and VectorBF are BasicVector<double> and BasicVector<bigfloat>.
+// Arithmetic operators are lazy, see expression_templates.h.
+template <typename T>
+class BasicVector : public VectorExpression<BasicVector<T>, T> {
+ private:
+  using traits = scalar_traits<T>;
+
+  std::vector<T> components_;
+
+  void check_dimension(size_t expected, const std::string& operation) const;
+  void check_non_zero() const;
+
+  // EPS = 0 in is_point_on_segment: pt - a is a multiple of b - a, by the
+  // pivoted minors of are_collinear, and the projection lies in [a, b]:
+  // (pt - a).(b - a) >= 0 and (b - pt).(b - a) >= 0. No rounding anywhere.
+  static bool exactly_on_segment(const BasicVector& pt, const BasicVector& a,
+                                 const BasicVector& b) {
+    const size_t n = pt.dimension();
+    size_t p = 0;
+    while (p < n && a[p] == b[p]) {
+      ++p;
+    }
+    if (p == n) {
+      return pt == a;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      if (i != p &&
+          orientation_sign(pt[p], pt[i], b[p], b[i], a[p], a[i]) != 0) {
+        return false;
+      }
+    }
+    const T* pt_data = pt.components_.data();
+    const T* a_data = a.components_.data();
+    const T* b_data = b.components_.data();
+    return difference_dot_sign(pt_data, a_data, b_data, a_data, n) >= 0 &&
+           difference_dot_sign(b_data, pt_data, b_data, a_data, n) >= 0;
+  }
+
+ public:
+  using value_type = T;
+
+  BasicVector() = default;
+  explicit BasicVector(size_t dimension) : components_(dimension, T(0)) {}
+  BasicVector(const std::vector<T>& components) : components_(components) {}
+  BasicVector(std::initializer_list<T> init) : components_(init) {}
+
+  // Evaluates an expression in a single pass.
+  template <typename E>
+  BasicVector(const VectorExpression<E, T>& expression);
+  template <typename E>
+  BasicVector& operator=(const VectorExpression<E, T>& expression) &;
+
+  size_t dimension() const noexcept { return components_.size(); }
+  const std::vector<T>& components() const { return components_; }
+
+  const T& operator[](size_t index) const;
+  T& operator[](size_t index);
+
+  // Unchecked access for inner loops and expression evaluation.
+  const T& operator()(size_t index) const noexcept {
+    return components_[index];
+  }
+
+  template <typename E>
+  BasicVector& operator+=(const VectorExpression<E, T>& other) &;
+  template <typename E>
+  BasicVector& operator-=(const VectorExpression<E, T>& other) &;
+  BasicVector& operator*=(const T& scalar) &;
+  BasicVector& operator/=(const T& scalar) &;
+
+  BasicVector operator+() const { return *this; }
+
+  friend bool operator==(const BasicVector& first, const BasicVector& second) {
+    return first.components_ == second.components_;
+  }
+  friend bool operator!=(const BasicVector& first, const BasicVector& second) {
+    return !(first == second);
+  }
+
+  T dot(const BasicVector& other) const;
+  T norm() const;
+
+  BasicVector normalize(const T& EPS = traits::smallest_norm()) const;
+
+  BasicVector cross_3d(const BasicVector& other) const;
+  BasicVector cross_7d(const BasicVector& other) const;
+
+  static T triple_product_3d(const BasicVector& a, const BasicVector& b,
+                             const BasicVector& c) {
+    return a.dot(b.cross_3d(c));
+  }
+  static T triple_product_7d(const BasicVector& a, const BasicVector& b,
+                             const BasicVector& c) {
+    return a.dot(b.cross_7d(c));
+  }
+
+  bool is_zero() const;
+  // Exact for double too, see robust_predicates.h.
+  bool is_orthogonal_to(const BasicVector& other) const {
+    check_dimension(other.dimension(), "is_orthogonal_to");
+    return difference_dot_sign<T>(components_.data(), nullptr,
+                                  other.components_.data(), nullptr,
+                                  dimension()) == 0;
+  }
+
+  std::string to_string() const;
+
+  static BasicVector zero(size_t dimension) { return BasicVector(dimension); }
+  static BasicVector basis_vector(size_t dimension, size_t index);
+
+  // Hidden friends rather than templates, so that unevaluated expressions
+  // and literals of another type (1e-10 for a VectorBF) still convert.
+
+  friend T angle_between(const BasicVector& a, const BasicVector& b,
+                         const T& EPS = traits::smallest_norm()) {
+    a.check_dimension(b.dimension(), "angle_between");
+    if (a.is_zero() || b.is_zero()) {
+      throw std::domain_error("Angle with zero vector is undefined");
+    }
+    const T norms_product = a.norm() * b.norm();
+    if (norms_product == T(0) || norms_product < EPS) {
+      throw std::domain_error("Vectors too small for angle calculation");
+    }
+    return traits::acos(a.dot(b) / norms_product, EPS * T(1000));
+  }
+
+  friend bool are_orthogonal(const BasicVector& a, const BasicVector& b) {
+    return a.is_orthogonal_to(b);
+  }
+
+  // Every 2x2 minor of [a b] vanishes. With a[p] != 0 that already follows
+  // from the minors a[p] b[i] - a[i] b[p], which say b = (b[p] / a[p]) a,
+  // so n - 1 exact signs decide it instead of n (n - 1) / 2.
+  friend bool are_collinear(const BasicVector& a, const BasicVector& b) {
+    if (a.dimension() != b.dimension()) {
+      return false;
+    }
+    if (a.is_zero() || b.is_zero()) {
+      return true;
+    }
+    size_t p = 0;
+    while (a[p] == T(0)) {
+      ++p;
+    }
+    const T zero(0);
+    for (size_t i = 0; i < a.dimension(); ++i) {
+      if (i != p &&
+          orientation_sign(a[p], a[i], b[p], b[i], zero, zero) != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Within EPS of the line through a and b and of the parameter range
+  // [0, 1]; EPS = 0 gives the exact answer, even for double.
+  friend bool is_point_on_segment(const BasicVector& pt, const BasicVector& a,
+                                  const BasicVector& b,
+                                  const T& EPS = traits::tolerance()) {
+    pt.check_dimension(a.dimension(), "is_point_on_segment");
+    pt.check_dimension(b.dimension(), "is_point_on_segment");
+    if (EPS == T(0)) {
+      return exactly_on_segment(pt, a, b);
+    }
+    const BasicVector ab = b - a;
+    const BasicVector ap = pt - a;
+    for (size_t i = 0; i < ab.dimension(); ++i) {
+      for (size_t j = i + 1; j < ab.dimension(); ++j) {
+        if (traits::abs(ap[i] * ab[j] - ap[j] * ab[i]) > EPS) {
+          return false;
+        }
+      }
+    }
+    const T ab2 = ab.dot(ab);
+    if (ab2 == T(0)) {
+      return pt == a;
+    }
+    const T t = ap.dot(ab) / ab2;
+    return t >= -EPS && t <= T(1) + EPS;
+  }
+
+  friend T point_to_segment_distance(const BasicVector& pt,
+                                     const BasicVector& a,
+                                     const BasicVector& b) {
+    pt.check_dimension(a.dimension(), "point_to_segment_distance");
+    pt.check_dimension(b.dimension(), "point_to_segment_distance");
+    const BasicVector ab = b - a;
+    const BasicVector ap = pt - a;
+    const T ab2 = ab.dot(ab);
+    if (ab2 == T(0)) {
+      return ap.norm();
+    }
+    T t = ap.dot(ab) / ab2;
+    if (t < T(0)) {
+      t = T(0);
+    } else if (t > T(1)) {
+      t = T(1);
+    }
+    return (pt - (a + ab * t)).norm();
+  }
+};
+
+template <typename T>
+void BasicVector<T>::check_dimension(size_t expected,
+                                     const std::string& operation) const {
+  if (dimension() != expected) {
+    throw std::invalid_argument(
+        "Vector::" + operation + " - dimension mismatch: " +
+        std::to_string(dimension()) + " != " + std::to_string(expected));
+  }
+}
+
+template <typename T>
+void BasicVector<T>::check_non_zero() const {
+  if (is_zero()) {
+    throw std::domain_error("Vector operation on zero vector");
+  }
+}
+
+template <typename T>
+const T& BasicVector<T>::operator[](size_t index) const {
+  if (index >= dimension()) {
+    throw std::out_of_range("Vector index out of range");
+  }
+  return components_[index];
+}
+
+template <typename T>
+T& BasicVector<T>::operator[](size_t index) {
+  if (index >= dimension()) {
+    throw std::out_of_range("Vector index out of range");
+  }
+  return components_[index];
+}
+
+template <typename T>
+template <typename E>
+BasicVector<T>::BasicVector(const VectorExpression<E, T>& expression) {
+  const E& source = expression.derived();
+  components_.reserve(source.dimension());
+  for (size_t i = 0; i < source.dimension(); ++i) {
+    components_.push_back(source(i));
+  }
+}
+
+// Element i of the expression depends only on element i of its operands,
+// so writing in place is safe even when *this is one of them.
+template <typename T>
+template <typename E>
+BasicVector<T>& BasicVector<T>::operator=(
+    const VectorExpression<E, T>& expression) & {
+  const E& source = expression.derived();
+  components_.resize(source.dimension());
+  for (size_t i = 0; i < components_.size(); ++i) {
+    components_[i] = source(i);
+  }
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+BasicVector<T>& BasicVector<T>::operator+=(
+    const VectorExpression<E, T>& other) & {
+  const E& source = other.derived();
+  check_dimension(source.dimension(), "operator+=");
+  for (size_t i = 0; i < dimension(); ++i) {
+    components_[i] += source(i);
+  }
+  return *this;
+}
+
+template <typename T>
+template <typename E>
+BasicVector<T>& BasicVector<T>::operator-=(
+    const VectorExpression<E, T>& other) & {
+  const E& source = other.derived();
+  check_dimension(source.dimension(), "operator-=");
+  for (size_t i = 0; i < dimension(); ++i) {
+    components_[i] -= source(i);
+  }
+  return *this;
+}
+
+template <typename T>
+BasicVector<T>& BasicVector<T>::operator*=(const T& scalar) & {
+  for (auto& component : components_) {
+    component *= scalar;
+  }
+  return *this;
+}
+
+template <typename T>
+BasicVector<T>& BasicVector<T>::operator/=(const T& scalar) & {
+  if (scalar == T(0)) {
+    throw std::domain_error("Division by zero");
+  }
+  for (auto& component : components_) {
+    component /= scalar;
+  }
+  return *this;
+}
+
+template <typename T>
+T BasicVector<T>::dot(const BasicVector& other) const {
+  check_dimension(other.dimension(), "dot");
+  T result(0);
+  for (size_t i = 0; i < dimension(); ++i) {
+    result += components_[i] * other.components_[i];
+  }
+  return result;
+}
+
+template <typename T>
+T BasicVector<T>::norm() const {
+  return traits::sqrt(dot(*this), traits::epsilon());
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::normalize(const T& EPS) const {
+  check_non_zero();
+  const T n = norm();
+  if (n == T(0) || n < EPS) {
+    throw std::domain_error("Cannot normalize zero vector");
+  }
+  return *this / n;
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::cross_3d(const BasicVector& other) const {
+  check_dimension(3, "cross_3d");
+  other.check_dimension(3, "cross_3d");
+  const auto& a = components_;
+  const auto& b = other.components_;
+  return BasicVector{a[1] * b[2] - a[2] * b[1],
+                     a[2] * b[0] - a[0] * b[2],
+                     a[0] * b[1] - a[1] * b[0]};
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::cross_7d(const BasicVector& other) const {
+  check_dimension(7, "cross_7d");
+  other.check_dimension(7, "cross_7d");
+  const auto& a = components_;
+  const auto& b = other.components_;
+  return BasicVector{
+      a[1] * b[3] - a[3] * b[1] + a[2] * b[6] - a[6] * b[2] + a[4] * b[5] - a[5] * b[4],
+      a[2] * b[4] - a[4] * b[2] + a[3] * b[0] - a[0] * b[3] + a[5] * b[6] - a[6] * b[5],
+      a[3] * b[5] - a[5] * b[3] + a[4] * b[1] - a[1] * b[4] + a[6] * b[0] - a[0] * b[6],
+      a[4] * b[6] - a[6] * b[4] + a[5] * b[2] - a[2] * b[5] + a[0] * b[1] - a[1] * b[0],
+      a[5] * b[0] - a[0] * b[5] + a[6] * b[3] - a[3] * b[6] + a[1] * b[2] - a[2] * b[1],
+      a[6] * b[1] - a[1] * b[6] + a[0] * b[4] - a[4] * b[0] + a[2] * b[3] - a[3] * b[2],
+      a[0] * b[2] - a[2] * b[0] + a[1] * b[5] - a[5] * b[1] + a[3] * b[4] - a[4] * b[3]};
+}
+
+template <typename T>
+bool BasicVector<T>::is_zero() const {
+  for (const auto& component : components_) {
+    if (component != T(0)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+BasicVector<T> BasicVector<T>::basis_vector(size_t dimension, size_t index) {
+  if (index >= dimension) {
+    throw std::out_of_range("Basis vector index out of range");
+  }
+  BasicVector result(dimension);
+  result[index] = T(1);
+  return result;
+}
+
+template <typename T>
+std::string BasicVector<T>::to_string() const {
+  if (components_.empty()) {
+    return "[]";
+  }
+  std::string result = "[";
+  for (size_t i = 0; i < components_.size(); ++i) {
+    if (i != 0) {
+      result += ", ";
+    }
+    result += scalar_traits<T>::to_string(components_[i]);
+  }
+  result += "]";
+  return result;
+}
+
+extern template class BasicVector<bigfloat>;
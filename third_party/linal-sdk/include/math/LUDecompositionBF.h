@@ -0,0 +1,8 @@
+#pragma once
+
+#include "BasicLUDecomposition.h"
+#include "BasicUpdatableLU.h"
+#include "MatrixBF.h"
+
+using LUDecompositionBF = BasicLUDecomposition<bigfloat>;
+using UpdatableLUBF = BasicUpdatableLU<bigfloat>;
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "BasicQRDecomposition.h"
+#include "MatrixBF.h"
+
+using QRDecompositionBF = BasicQRDecomposition<bigfloat>;
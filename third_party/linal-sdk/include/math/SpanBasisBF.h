@@ -0,0 +1,6 @@
+#pragma once
+
+#include "BasicSpanBasis.h"
+#include "VectorBF.h"
+
+using SpanBasisBF = BasicSpanBasis<bigfloat>;
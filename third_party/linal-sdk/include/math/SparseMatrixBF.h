@@ -0,0 +1,8 @@
+#pragma once
+
+#include "BasicSparseLU.h"
+#include "BasicSparseMatrix.h"
+#include "MatrixBF.h"
+
+using SparseMatrixBF = BasicSparseMatrix<bigfloat>;
+using SparseLUBF = BasicSparseLU<bigfloat>;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+// Allocator handing out storage aligned to `Alignment` bytes, so vector
+// kernels never straddle a cache line at the start of a buffer. The default
+// covers one AVX-512 register and one cache line.
+template <typename T, size_t Alignment = 64>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+
+  static_assert(Alignment >= alignof(T), "Alignment weaker than the type's");
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(
+        ::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+  }
+  void deallocate(T* pointer, size_t /*count*/) noexcept {
+    ::operator delete(pointer, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>& /*other*/) const noexcept {
+    return true;
+  }
+};
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "bigmath/bigfloat.hpp"
+
+// Decimal digits of `value` ("-" prefixed when negative) if it is an
+// integer, std::nullopt otherwise. The decimal form is parsed back and
+// compared exactly, so a value that merely rounds to an integer is rejected.
+std::optional<std::string> integer_digits(const bigfloat& value);
+
+bool is_integral(const bigfloat& value);
+
+// `value` cut to `digits` decimal places through its decimal form. Bounds
+// the size of numerators and denominators in long iterative computations.
+bigfloat rounded(const bigfloat& value, size_t digits);
+
+// Decimal places needed to resolve `eps` (eps > 0).
+size_t decimal_places(const bigfloat& eps);
+
+// Nearest double, through a decimal form with 17 significant digits.
+double to_double(const bigfloat& value);
+
+// The shortest decimal that round-trips `value`, as a bigfloat.
+bigfloat from_double(double value);
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+// Lazy element-wise arithmetic for BasicVector and BasicMatrix.
+//
+// a + b, a - b, -a, a * s, s * a and a / s return small expression objects
+// instead of results. Nothing is computed until an expression is assigned
+// to (or used to construct) a vector or matrix, which then fills every
+// element in one pass: `x = x - delta` or `a + ab * t` touch each element
+// once and allocate no intermediate vectors. Every node only reads index i
+// to produce element i, so the destination may also appear on the right.
+//
+// Operands that are lvalues are held by reference, temporaries are moved
+// into the expression, so `auto e = x - F(x);` stays valid as long as x
+// does. Matrix products are not element-wise and are evaluated eagerly.
+
+template <typename T>
+class BasicVector;
+template <typename T>
+class BasicMatrix;
+
+// Lvalue operands are referenced, rvalues are owned by the node.
+template <typename E>
+using expression_operand_t =
+    std::conditional_t<std::is_lvalue_reference_v<E>,
+                       const std::remove_reference_t<E>&,
+                       std::remove_cvref_t<E>>;
+
+template <typename E>
+using expression_value_t = typename std::remove_cvref_t<E>::value_type;
+
+// CRTP base of everything usable as a vector operand. Derived provides
+// dimension() and an unchecked operator()(i).
+template <typename Derived, typename T>
+class VectorExpression {
+ public:
+  using value_type = T;
+
+  const Derived& derived() const noexcept {
+    return static_cast<const Derived&>(*this);
+  }
+
+  BasicVector<T> eval() const { return BasicVector<T>(derived()); }
+
+  // The common queries on an unevaluated result, e.g. (x_new - x).norm().
+  T dot(const BasicVector<T>& other) const { return eval().dot(other); }
+  T norm() const { return eval().norm(); }
+  bool is_zero() const { return eval().is_zero(); }
+  std::string to_string() const { return eval().to_string(); }
+};
+
+// CRTP base of everything usable as a matrix operand. Derived provides
+// rows(), cols() and an unchecked operator()(row, col).
+template <typename Derived, typename T>
+class MatrixExpression {
+ public:
+  using value_type = T;
+
+  const Derived& derived() const noexcept {
+    return static_cast<const Derived&>(*this);
+  }
+
+  BasicMatrix<T> eval() const { return BasicMatrix<T>(derived()); }
+
+  std::string to_string() const { return eval().to_string(); }
+};
+
+template <typename E>
+concept vector_expression =
+    requires { typename expression_value_t<E>; } &&
+    std::derived_from<std::remove_cvref_t<E>,
+                      VectorExpression<std::remove_cvref_t<E>,
+                                       expression_value_t<E>>>;
+
+template <typename E>
+concept matrix_expression =
+    requires { typename expression_value_t<E>; } &&
+    std::derived_from<std::remove_cvref_t<E>,
+                      MatrixExpression<std::remove_cvref_t<E>,
+                                       expression_value_t<E>>>;
+
+template <typename L, typename R>
+concept same_scalar = std::same_as<expression_value_t<L>, expression_value_t<R>>;
+
+template <typename L, typename R, typename Op>
+class VectorBinaryExpression
+    : public VectorExpression<VectorBinaryExpression<L, R, Op>,
+                              expression_value_t<L>> {
+ private:
+  expression_operand_t<L> lhs_;
+  expression_operand_t<R> rhs_;
+
+ public:
+  VectorBinaryExpression(L&& lhs, R&& rhs)
+      : lhs_(std::forward<L>(lhs)), rhs_(std::forward<R>(rhs)) {}
+
+  size_t dimension() const noexcept { return lhs_.dimension(); }
+  expression_value_t<L> operator()(size_t i) const {
+    return Op{}(lhs_(i), rhs_(i));
+  }
+};
+
+// Element i is Op(operand(i), scalar); scalars stay on the right since
+// every supported scalar type multiplies commutatively.
+template <typename E, typename Op>
+class VectorScalarExpression
+    : public VectorExpression<VectorScalarExpression<E, Op>,
+                              expression_value_t<E>> {
+ private:
+  expression_operand_t<E> operand_;
+  expression_value_t<E> scalar_;
+
+ public:
+  VectorScalarExpression(E&& operand, expression_value_t<E> scalar)
+      : operand_(std::forward<E>(operand)), scalar_(std::move(scalar)) {}
+
+  size_t dimension() const noexcept { return operand_.dimension(); }
+  expression_value_t<E> operator()(size_t i) const {
+    return Op{}(operand_(i), scalar_);
+  }
+};
+
+template <typename E>
+class VectorNegation
+    : public VectorExpression<VectorNegation<E>, expression_value_t<E>> {
+ private:
+  expression_operand_t<E> operand_;
+
+ public:
+  explicit VectorNegation(E&& operand) : operand_(std::forward<E>(operand)) {}
+
+  size_t dimension() const noexcept { return operand_.dimension(); }
+  expression_value_t<E> operator()(size_t i) const { return -operand_(i); }
+};
+
+template <typename L, typename R, typename Op>
+class MatrixBinaryExpression
+    : public MatrixExpression<MatrixBinaryExpression<L, R, Op>,
+                              expression_value_t<L>> {
+ private:
+  expression_operand_t<L> lhs_;
+  expression_operand_t<R> rhs_;
+
+ public:
+  MatrixBinaryExpression(L&& lhs, R&& rhs)
+      : lhs_(std::forward<L>(lhs)), rhs_(std::forward<R>(rhs)) {}
+
+  size_t rows() const noexcept { return lhs_.rows(); }
+  size_t cols() const noexcept { return lhs_.cols(); }
+  expression_value_t<L> operator()(size_t row, size_t col) const {
+    return Op{}(lhs_(row, col), rhs_(row, col));
+  }
+};
+
+template <typename E, typename Op>
+class MatrixScalarExpression
+    : public MatrixExpression<MatrixScalarExpression<E, Op>,
+                              expression_value_t<E>> {
+ private:
+  expression_operand_t<E> operand_;
+  expression_value_t<E> scalar_;
+
+ public:
+  MatrixScalarExpression(E&& operand, expression_value_t<E> scalar)
+      : operand_(std::forward<E>(operand)), scalar_(std::move(scalar)) {}
+
+  size_t rows() const noexcept { return operand_.rows(); }
+  size_t cols() const noexcept { return operand_.cols(); }
+  expression_value_t<E> operator()(size_t row, size_t col) const {
+    return Op{}(operand_(row, col), scalar_);
+  }
+};
+
+template <typename L, typename R>
+void check_same_dimension(const L& lhs, const R& rhs,
+                          const std::string& operation) {
+  if (lhs.dimension() != rhs.dimension()) {
+    throw std::invalid_argument(
+        "Vector::" + operation + " - dimension mismatch: " +
+        std::to_string(lhs.dimension()) + " != " +
+        std::to_string(rhs.dimension()));
+  }
+}
+
+template <typename L, typename R>
+void check_same_shape(const L& lhs, const R& rhs, const std::string& op) {
+  if (lhs.rows() != rhs.rows() || lhs.cols() != rhs.cols()) {
+    throw std::runtime_error("Matrix size mismatch in operation: " + op);
+  }
+}
+
+template <typename T>
+void check_nonzero_divisor(const T& scalar) {
+  if (scalar == T(0)) {
+    throw std::domain_error("Division by zero");
+  }
+}
+
+template <vector_expression L, vector_expression R>
+  requires same_scalar<L, R>
+VectorBinaryExpression<L, R, std::plus<>> operator+(L&& lhs, R&& rhs) {
+  check_same_dimension(lhs, rhs, "operator+");
+  return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <vector_expression L, vector_expression R>
+  requires same_scalar<L, R>
+VectorBinaryExpression<L, R, std::minus<>> operator-(L&& lhs, R&& rhs) {
+  check_same_dimension(lhs, rhs, "operator-");
+  return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <vector_expression E>
+VectorNegation<E> operator-(E&& operand) {
+  return VectorNegation<E>(std::forward<E>(operand));
+}
+
+template <vector_expression E>
+VectorScalarExpression<E, std::multiplies<>> operator*(
+    E&& operand, const expression_value_t<E>& scalar) {
+  return {std::forward<E>(operand), scalar};
+}
+
+template <vector_expression E>
+VectorScalarExpression<E, std::multiplies<>> operator*(
+    const expression_value_t<E>& scalar, E&& operand) {
+  return {std::forward<E>(operand), scalar};
+}
+
+template <vector_expression E>
+VectorScalarExpression<E, std::divides<>> operator/(
+    E&& operand, const expression_value_t<E>& scalar) {
+  check_nonzero_divisor(scalar);
+  return {std::forward<E>(operand), scalar};
+}
+
+template <matrix_expression L, matrix_expression R>
+  requires same_scalar<L, R>
+MatrixBinaryExpression<L, R, std::plus<>> operator+(L&& lhs, R&& rhs) {
+  check_same_shape(lhs, rhs, "+");
+  return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <matrix_expression L, matrix_expression R>
+  requires same_scalar<L, R>
+MatrixBinaryExpression<L, R, std::minus<>> operator-(L&& lhs, R&& rhs) {
+  check_same_shape(lhs, rhs, "-");
+  return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <matrix_expression E>
+MatrixScalarExpression<E, std::multiplies<>> operator*(
+    E&& operand, const expression_value_t<E>& scalar) {
+  return {std::forward<E>(operand), scalar};
+}
+
+template <matrix_expression E>
+MatrixScalarExpression<E, std::multiplies<>> operator*(
+    const expression_value_t<E>& scalar, E&& operand) {
+  return {std::forward<E>(operand), scalar};
+}
+
+// Products are evaluated on the spot by BasicMatrix::operator*=.
+template <matrix_expression L, matrix_expression R>
+  requires same_scalar<L, R>
+BasicMatrix<expression_value_t<L>> operator*(L&& lhs, R&& rhs) {
+  BasicMatrix<expression_value_t<L>> result(std::forward<L>(lhs));
+  result *= rhs;
+  return result;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "bigmath/bigfloat.hpp"
+
+template <typename T>
+class BasicMatrix;
+using MatrixBF = BasicMatrix<bigfloat>;
+
+// Exact linear algebra for integer-valued matrices: the work is done in
+// native uint64 arithmetic modulo primes in (2^61, 2^62), one prime per
+// thread, and the exact result is rebuilt with the Chinese remainder
+// theorem. The number of primes follows from the Hadamard bound, so the
+// answers are exact, not probabilistic.
+//
+// Every entry point returns std::nullopt when some entry is not an integer;
+// callers are expected to fall back to bigfloat elimination then.
+
+// The first `count` primes below 2^62, in decreasing order.
+std::vector<uint64_t> modular_primes(size_t count);
+
+// `digits` as produced by integer_digits(), reduced modulo `prime`.
+uint64_t decimal_residue(const std::string& digits, uint64_t prime);
+
+// The unique integer x with |x| < (p_0 * ... * p_k) / 2 and
+// x = residues[i] (mod primes[i]).
+bigfloat crt_reconstruct(const std::vector<uint64_t>& residues,
+                         const std::vector<uint64_t>& primes);
+
+std::optional<bigfloat> modular_determinant(const MatrixBF& matrix);
+std::optional<size_t> modular_rank(const MatrixBF& matrix);
+// Throws std::runtime_error("No unique solution") for a singular matrix.
+std::optional<std::vector<bigfloat>> modular_solve(
+    const MatrixBF& matrix, const std::vector<bigfloat>& b);
+
+// lhs * rhs for integer matrices. Each prime's product is split by rows
+// over the parallel_for workers, which only ever see uint64 residues, so
+// the product uses every core however many primes it needs.
+std::optional<MatrixBF> modular_multiply(const MatrixBF& lhs,
+                                         const MatrixBF& rhs);
+
+// Coefficients of the product of two integer polynomials, lowest degree
+// first, by number-theoretic transforms modulo primes c * 2^32 + 1 and the
+// Chinese remainder theorem. The prime count follows from the coefficient
+// bound min(|a|, |b|) * max|a_i| * max|b_j|, so the result is exact.
+std::optional<std::vector<bigfloat>> modular_convolution(
+    const std::vector<bigfloat>& a, const std::vector<bigfloat>& b);
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Largest number of threads parallel_for uses, caller included; 0 (the
+// default) means hardware_concurrency().
+inline std::atomic<size_t>& parallel_worker_limit() {
+  static std::atomic<size_t> limit{0};
+  return limit;
+}
+inline void set_parallel_workers(size_t count) {
+  parallel_worker_limit().store(count);
+}
+
+// Runs body(i) for every i in [begin, end) on up to hardware_concurrency()
+// threads, or the limit set with set_parallel_workers(). Indices are handed
+// out one at a time, so uneven tasks balance themselves. The first
+// exception thrown by any task is rethrown here.
+template <typename Function>
+void parallel_for(size_t begin, size_t end, Function&& body) {
+  if (begin >= end) {
+    return;
+  }
+  const size_t count = end - begin;
+  const size_t limit = parallel_worker_limit().load();
+  const size_t workers = std::min<size_t>(
+      count, limit != 0 ? limit
+                        : std::max(1u, std::thread::hardware_concurrency()));
+  if (workers == 1) {
+    for (size_t i = begin; i < end; ++i) {
+      body(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next{begin};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    for (size_t i = next++; i < end; i = next++) {
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next = end;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(workers - 1);
+  for (size_t t = 1; t < workers; ++t) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+// Multiply-adds of double below which starting the threads of a
+// parallel_for costs more than it saves.
+constexpr size_t kParallelMinimumWork = size_t(1) << 20;
+
+// parallel_for when `parallel` holds, a plain loop on the calling thread
+// otherwise, for kernels whose scalar type or size does not always
+// warrant threads.
+template <typename Function>
+void parallel_for_if(bool parallel, size_t begin, size_t end,
+                     Function&& body) {
+  if (parallel) {
+    parallel_for(begin, end, body);
+    return;
+  }
+  for (size_t i = begin; i < end; ++i) {
+    body(i);
+  }
+}
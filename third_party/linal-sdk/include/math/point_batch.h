@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "BasicVector.h"
+#include "aligned_allocator.h"
+#include "scalar_traits.h"
+
+// Many double points of one dimension stored as a structure of arrays:
+// coordinate k of every point is contiguous, so the batch kernels below
+// handle 4 points per AVX2 instruction with plain loads. Like
+// simd_kernels.h, each kernel picks the AVX2 or the portable implementation
+// once, from what the running CPU supports.
+//
+// The kernels answer the BasicVector predicates of the same name for every
+// point against one segment or direction, writing one result per point to
+// `out`, which must hold size() values. Nothing is allocated per point,
+// and results may differ from the single-point versions in the last bit.
+class PointBatch {
+ private:
+  using Coordinates = std::vector<double, AlignedAllocator<double>>;
+
+  std::vector<Coordinates> coordinates_;
+  size_t size_{};
+
+ public:
+  explicit PointBatch(size_t dimension) : coordinates_(dimension) {}
+  explicit PointBatch(const std::vector<BasicVector<double>>& points);
+
+  size_t dimension() const noexcept { return coordinates_.size(); }
+  size_t size() const noexcept { return size_; }
+
+  void reserve(size_t count);
+  void push_back(const BasicVector<double>& point);
+  void clear() noexcept;
+
+  // Coordinate `axis` of every point, size() values.
+  const double* coordinate(size_t axis) const noexcept {
+    return coordinates_[axis].data();
+  }
+  BasicVector<double> point(size_t index) const;
+};
+
+void point_to_segment_distance(const PointBatch& points,
+                               const BasicVector<double>& a,
+                               const BasicVector<double>& b, double* out);
+
+// EPS = 0 asks for the exact test, which runs point by point.
+void is_point_on_segment(const PointBatch& points,
+                         const BasicVector<double>& a,
+                         const BasicVector<double>& b, bool* out,
+                         double EPS = scalar_traits<double>::tolerance());
+
+// Angle between every point, taken as a vector, and `direction`. Points
+// for which the single-point version throws (zero or too short) get NaN;
+// a zero `direction` throws as it does there.
+void angle_between(const PointBatch& points,
+                   const BasicVector<double>& direction, double* out,
+                   double EPS = scalar_traits<double>::smallest_norm());
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <string>
+
+#include "bigfloat_util.h"
+#include "bigmath/bigfloat.hpp"
+
+// Compile-time description of a scalar type for BasicMatrix and
+// BasicVector. The generic algorithms are written once; everything that
+// depends on whether arithmetic is exact or rounded lives here.
+//
+// A new scalar type needs a specialization providing every member below.
+template <typename T>
+struct scalar_traits;
+
+template <std::floating_point T>
+struct scalar_traits<T> {
+  // Exact types pivot on the first nonzero entry and may use Bareiss
+  // elimination and Strassen products, neither of which is stable in
+  // rounded arithmetic.
+  static constexpr bool exact = false;
+  // Largest-magnitude pivot instead of the first nonzero one.
+  static constexpr bool partial_pivoting = true;
+  // Products and factorization updates may run on parallel_for workers.
+  // A multiply-add is far cheaper than starting a thread, so kernels only
+  // do so from kParallelMinimumWork multiply-adds on.
+  static constexpr bool parallel_kernels = true;
+  // Products, transposes and row updates go through simd_kernels.h.
+  static constexpr bool simd_kernels = std::same_as<T, double>;
+
+  // Default convergence tolerance for iterative methods.
+  static T epsilon() { return std::numeric_limits<T>::epsilon(); }
+  // Absolute tolerance for rank decisions and geometric predicates.
+  static T tolerance() {
+    return std::fmax(T(1e-10), T(1000) * std::numeric_limits<T>::epsilon());
+  }
+  // Default floor on the norms normalize() and angle_between() divide by.
+  // Hardware division is defined for any nonzero norm, so only zero is
+  // refused.
+  static T smallest_norm() { return T(0); }
+
+  static T abs(const T& value) { return std::fabs(value); }
+  static T sqrt(const T& value, const T& /*eps*/) { return std::sqrt(value); }
+  static T acos(const T& value, const T& /*eps*/) {
+    return std::acos(std::fmax(T(-1), std::fmin(T(1), value)));
+  }
+
+  // Rounding happens in hardware, so there is nothing to trim.
+  static size_t decimal_places(const T& /*eps*/) { return 0; }
+  static T rounded(const T& value, size_t /*digits*/) { return value; }
+  static bool is_integral(const T& value) { return std::trunc(value) == value; }
+
+  static std::string to_string(const T& value) { return std::to_string(value); }
+};
+
+template <>
+struct scalar_traits<bigfloat> {
+  static constexpr bool exact = true;
+  static constexpr bool partial_pivoting = false;
+  // bigfloat arithmetic stays on the calling thread, as in
+  // modular_linalg.cpp: the library does not promise that concurrent
+  // operations on distinct values are safe. Integer products still use
+  // every core, through modular_multiply().
+  static constexpr bool parallel_kernels = false;
+  static constexpr bool simd_kernels = false;
+
+  static bigfloat epsilon() { return bigfloat::DEFAULT_EPS; }
+  // Rank decisions stay exact; only geometric predicates use this.
+  static bigfloat tolerance() { return bigfloat::DEFAULT_EPS; }
+  // Norms come from a square root computed to DEFAULT_EPS, so anything
+  // smaller is indistinguishable from zero.
+  static bigfloat smallest_norm() { return bigfloat::DEFAULT_EPS; }
+
+  static bigfloat abs(const bigfloat& value) { return value.abs(); }
+  static bigfloat sqrt(const bigfloat& value, const bigfloat& eps) {
+    return ::sqrt(value, eps);
+  }
+  static bigfloat acos(const bigfloat& value, const bigfloat& eps) {
+    return arccos(value, eps);
+  }
+
+  // Long iterations keep entries to a fixed number of decimals so that
+  // numerators and denominators do not grow without bound.
+  static size_t decimal_places(const bigfloat& eps) {
+    return ::decimal_places(eps);
+  }
+  static bigfloat rounded(const bigfloat& value, size_t digits) {
+    return ::rounded(value, digits);
+  }
+  static bool is_integral(const bigfloat& value) {
+    return ::is_integral(value);
+  }
+
+  static std::string to_string(const bigfloat& value) {
+    return value.to_decimal();
+  }
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BasicVector.h"
+#include "scalar_traits.h"
+
+// Bounding volume hierarchy over double line segments of any dimension,
+// answering nearest, radius and on-segment queries in roughly O(log N) node
+// visits instead of one predicate call per segment.
+//
+// Nodes hold axis-aligned boxes. The tree splits each range at the median
+// centroid along its widest axis, so the shape depends only on the segment
+// count. Every subtree therefore has a known place in the node array, and
+// the subtrees below the first levels are built in parallel. Boxes only
+// prune; every candidate is settled by point_to_segment_distance or
+// is_point_on_segment, so results match a linear scan.
+class SegmentIndex {
+ private:
+  static constexpr size_t kLeafSize = 4;
+  // 2^kParallelDepth subtrees are built as separate tasks.
+  static constexpr size_t kParallelDepth = 4;
+
+  struct Node {
+    // Leaves own order_[first, first + count); inner nodes have count 0,
+    // their left child right after them and the right child at `right`.
+    size_t first = 0;
+    size_t count = 0;
+    size_t right = 0;
+    // Bounds for pruning on-segment queries, see containing().
+    double max_length = 0.0;
+    double max_inverse_length = 0.0;
+  };
+
+  size_t dimension_{};
+  std::vector<BasicVector<double>> starts_;
+  std::vector<BasicVector<double>> ends_;
+  // Segment boxes, centroids and node boxes, dimension_ values each.
+  std::vector<double> lower_, upper_, centroid_;
+  std::vector<double> node_lower_, node_upper_;
+  std::vector<double> length_;
+  std::vector<Node> nodes_;
+  std::vector<size_t> order_;
+
+  static size_t node_count(size_t count);
+  void check_dimension(size_t dimension, const std::string& op) const;
+
+  struct BuildTask {
+    size_t node;
+    size_t begin;
+    size_t end;
+  };
+
+  // Fills `node` for order_[begin, end). Subtrees at kParallelDepth are
+  // left in `deferred` when it is given.
+  void build(size_t node, size_t begin, size_t end, size_t depth,
+             std::vector<BuildTask>* deferred);
+  double box_distance2(size_t node, const BasicVector<double>& point) const;
+
+ public:
+  SegmentIndex() = default;
+  // Segment i runs from segments[i].first to segments[i].second.
+  explicit SegmentIndex(
+      const std::vector<std::pair<BasicVector<double>, BasicVector<double>>>&
+          segments);
+
+  size_t size() const noexcept { return starts_.size(); }
+  size_t dimension() const noexcept { return dimension_; }
+  std::pair<BasicVector<double>, BasicVector<double>> segment(
+      size_t index) const {
+    return {starts_.at(index), ends_.at(index)};
+  }
+
+  // The k segments closest to `point`, nearest first; ties go to the lower
+  // index.
+  std::vector<size_t> nearest(const BasicVector<double>& point,
+                              size_t k = 1) const;
+  // Every segment within `radius` of `point`, by ascending index.
+  std::vector<size_t> within_radius(const BasicVector<double>& point,
+                                    double radius) const;
+  // Every segment for which is_point_on_segment(point, a, b, EPS) holds, by
+  // ascending index.
+  std::vector<size_t> containing(
+      const BasicVector<double>& point,
+      double EPS = scalar_traits<double>::tolerance()) const;
+
+  // Bulk versions, one query point per parallel_for task.
+  std::vector<std::vector<size_t>> nearest(
+      const std::vector<BasicVector<double>>& points, size_t k = 1) const;
+  std::vector<std::vector<size_t>> within_radius(
+      const std::vector<BasicVector<double>>& points, double radius) const;
+  std::vector<std::vector<size_t>> containing(
+      const std::vector<BasicVector<double>>& points,
+      double EPS = scalar_traits<double>::tolerance()) const;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+
+#include "scalar_traits.h"
+
+// Vectorised double kernels behind Matrix (BasicMatrix<double>). Each entry
+// point picks an AVX-512, AVX2+FMA or portable implementation once, from
+// what the running CPU supports, so one binary runs everywhere. The vector
+// paths fuse multiply and add, so results may differ from the portable path
+// in the last bit.
+//
+// All matrices are dense row-major with no padding between rows.
+
+// "avx512", "avx2" or "scalar": the implementation the kernels dispatch to.
+const char* simd_isa();
+
+// c = a * b for an m x k matrix a and a k x n matrix b. c is overwritten.
+void simd_gemm(const double* a, const double* b, double* c, size_t m,
+               size_t k, size_t n);
+
+// y[i] += alpha * x[i] for i < count.
+void simd_axpy(double* y, const double* x, double alpha, size_t count);
+
+// destination (cols x rows) = transpose of source (rows x cols).
+void simd_transpose(const double* source, double* destination, size_t rows,
+                    size_t cols);
+
+// target[i] -= factor * source[i] for i < count: the row update of every
+// elimination. Types without vector kernels keep the plain loop.
+template <typename T>
+void subtract_scaled(T* target, const T* source, const T& factor,
+                     size_t count) {
+  if constexpr (scalar_traits<T>::simd_kernels) {
+    simd_axpy(target, source, -factor, count);
+  } else {
+    for (size_t i = 0; i < count; ++i) {
+      target[i] -= factor * source[i];
+    }
+  }
+}
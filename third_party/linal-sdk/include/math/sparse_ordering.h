@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Fill-reducing orderings for sparse factorizations. They only look at the
+// nonzero pattern, so they are plain functions rather than templates.
+
+// Minimum degree ordering of an undirected graph given as adjacency lists
+// (vertex i is adjacent to every entry of adjacency[i]; duplicates and self
+// loops are ignored, the lists need not be symmetric). Each step eliminates
+// a vertex of smallest current degree, ties broken by the smaller index,
+// and turns its remaining neighbours into a clique, exactly as Gaussian
+// elimination fills in. The result lists the vertices in elimination order.
+std::vector<size_t> minimum_degree_ordering(
+    std::vector<std::vector<size_t>> adjacency);
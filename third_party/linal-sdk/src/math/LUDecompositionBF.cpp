@@ -0,0 +1,4 @@
+#include "LUDecompositionBF.h"
+
+template class BasicLUDecomposition<bigfloat>;
+template class BasicUpdatableLU<bigfloat>;
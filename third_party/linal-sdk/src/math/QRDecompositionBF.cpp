@@ -0,0 +1,3 @@
+#include "QRDecompositionBF.h"
+
+template class BasicQRDecomposition<bigfloat>;
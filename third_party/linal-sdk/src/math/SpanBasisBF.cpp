@@ -0,0 +1,3 @@
+#include "SpanBasisBF.h"
+
+template class BasicSpanBasis<bigfloat>;
@@ -0,0 +1,4 @@
+#include "SparseMatrixBF.h"
+
+template class BasicSparseMatrix<bigfloat>;
+template class BasicSparseLU<bigfloat>;
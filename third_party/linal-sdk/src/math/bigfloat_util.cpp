@@ -0,0 +1,105 @@
+#include "bigfloat_util.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+std::optional<std::string> integer_digits(const bigfloat& value) {
+  const std::string decimal = value.to_decimal();
+
+  size_t begin = 0;
+  bool negative = false;
+  if (!decimal.empty() && (decimal[0] == '-' || decimal[0] == '+')) {
+    negative = decimal[0] == '-';
+    begin = 1;
+  }
+
+  const size_t dot = decimal.find('.', begin);
+  const size_t end = dot == std::string::npos ? decimal.size() : dot;
+  if (end == begin) {
+    return std::nullopt;
+  }
+  for (size_t i = begin; i < end; ++i) {
+    if (decimal[i] < '0' || decimal[i] > '9') {
+      return std::nullopt;
+    }
+  }
+  for (size_t i = end + 1; i < decimal.size(); ++i) {
+    if (decimal[i] != '0') {
+      return std::nullopt;
+    }
+  }
+
+  std::string digits = decimal.substr(begin, end - begin);
+  if (bigfloat(digits) != value.abs()) {
+    return std::nullopt;
+  }
+
+  size_t first = digits.find_first_not_of('0');
+  if (first == std::string::npos) {
+    return std::string("0");
+  }
+  digits.erase(0, first);
+  if (negative) {
+    digits.insert(digits.begin(), '-');
+  }
+  return digits;
+}
+
+bool is_integral(const bigfloat& value) {
+  return integer_digits(value).has_value();
+}
+
+bigfloat rounded(const bigfloat& value, size_t digits) {
+  return bigfloat(value.to_decimal(digits));
+}
+
+size_t decimal_places(const bigfloat& eps) {
+  size_t places = 0;
+  bigfloat scaled = eps.abs();
+  if (scaled == 0) {
+    return places;
+  }
+  while (scaled < 1) {
+    scaled *= 10;
+    ++places;
+  }
+  return places;
+}
+
+double to_double(const bigfloat& value) {
+  constexpr size_t kSignificantDigits = 17;
+  // Below the smallest subnormal double everything rounds to zero.
+  constexpr size_t kMaxLeadingZeros = 330;
+
+  bigfloat magnitude = value.abs();
+  if (magnitude == 0) {
+    return 0.0;
+  }
+  size_t leading_zeros = 0;
+  while (magnitude < 1 && leading_zeros < kMaxLeadingZeros) {
+    magnitude *= 10;
+    ++leading_zeros;
+  }
+  return std::strtod(
+      value.to_decimal(leading_zeros + kSignificantDigits).c_str(), nullptr);
+}
+
+bigfloat from_double(double value) {
+  if (!std::isfinite(value)) {
+    throw std::domain_error("from_double: value is not finite");
+  }
+  // Fixed notation never needs more than ~1100 characters for a double.
+  char buffer[1200];
+  auto [end, error] =
+      std::to_chars(buffer, buffer + sizeof(buffer), value,
+                    std::chars_format::fixed);
+  if (error != std::errc()) {
+    throw std::runtime_error("from_double: conversion failed");
+  }
+  return bigfloat(std::string(buffer, end));
+}
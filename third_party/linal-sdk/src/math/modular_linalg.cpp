@@ -0,0 +1,607 @@
+#include "modular_linalg.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include "MatrixBF.h"
+#include "bigfloat_util.h"
+#include "parallel_for.h"
+
+namespace {
+
+// Every prime handed out exceeds 2^61, so k primes cover 61 * k bits.
+constexpr double kBitsPerPrime = 61.0;
+
+uint64_t mul_mod(uint64_t a, uint64_t b, uint64_t p) {
+  return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % p);
+}
+
+uint64_t add_mod(uint64_t a, uint64_t b, uint64_t p) {
+  uint64_t sum = a + b;
+  return sum >= p ? sum - p : sum;
+}
+
+uint64_t sub_mod(uint64_t a, uint64_t b, uint64_t p) {
+  return a >= b ? a - b : a + p - b;
+}
+
+uint64_t pow_mod(uint64_t base, uint64_t exp, uint64_t p) {
+  uint64_t result = 1;
+  base %= p;
+  while (exp != 0) {
+    if (exp & 1) {
+      result = mul_mod(result, base, p);
+    }
+    base = mul_mod(base, base, p);
+    exp >>= 1;
+  }
+  return result;
+}
+
+uint64_t inv_mod(uint64_t a, uint64_t p) { return pow_mod(a, p - 2, p); }
+
+// Deterministic Miller-Rabin for 64-bit n.
+bool is_prime(uint64_t n) {
+  if (n < 2) {
+    return false;
+  }
+  static const uint64_t kBases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+  for (uint64_t base : kBases) {
+    if (n % base == 0) {
+      return n == base;
+    }
+  }
+  uint64_t d = n - 1;
+  unsigned s = 0;
+  while ((d & 1) == 0) {
+    d >>= 1;
+    ++s;
+  }
+  for (uint64_t base : kBases) {
+    uint64_t x = pow_mod(base, d, n);
+    if (x == 1 || x == n - 1) {
+      continue;
+    }
+    bool composite = true;
+    for (unsigned r = 1; r < s; ++r) {
+      x = mul_mod(x, x, n);
+      if (x == n - 1) {
+        composite = false;
+        break;
+      }
+    }
+    if (composite) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t primes_for_bits(double bits) {
+  return static_cast<size_t>(std::ceil((bits + 1.0) / kBitsPerPrime)) + 1;
+}
+
+// Transform primes are c * 2^kNttOrderBits + 1, so each has roots of unity
+// of every power-of-two order up to 2^kNttOrderBits.
+constexpr unsigned kNttOrderBits = 32;
+
+// The first `count` primes c * 2^32 + 1 in (2^61, 2^62), decreasing, each
+// with a root of unity of order 2^32.
+std::vector<std::pair<uint64_t, uint64_t>> ntt_primes(size_t count) {
+  static std::mutex mutex;
+  static std::vector<std::pair<uint64_t, uint64_t>> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  uint64_t c = cache.empty() ? (uint64_t{1} << (62 - kNttOrderBits)) - 1
+                             : (cache.back().first >> kNttOrderBits) - 1;
+  while (cache.size() < count) {
+    const uint64_t p = (c << kNttOrderBits) + 1;
+    --c;
+    if (!is_prime(p)) {
+      continue;
+    }
+    // For a quadratic non-residue g, g^((p-1)/2) = -1, so g^c has order
+    // exactly 2^32.
+    for (uint64_t g = 3;; ++g) {
+      if (pow_mod(g, (p - 1) / 2, p) == p - 1) {
+        cache.emplace_back(p, pow_mod(g, p >> kNttOrderBits, p));
+        break;
+      }
+    }
+  }
+  return {cache.begin(), cache.begin() + count};
+}
+
+// In-place transform of a power-of-two length vector modulo p. `root` has
+// order 2^kNttOrderBits; the inverse transform includes the 1/n scaling.
+void ntt(std::vector<uint64_t>& a, uint64_t p, uint64_t root, bool inverse) {
+  const size_t n = a.size();
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j ^= bit;
+    if (i < j) {
+      std::swap(a[i], a[j]);
+    }
+  }
+  if (inverse) {
+    root = inv_mod(root, p);
+  }
+  for (size_t length = 2; length <= n; length <<= 1) {
+    const uint64_t step = pow_mod(root, (uint64_t{1} << kNttOrderBits) / length, p);
+    for (size_t start = 0; start < n; start += length) {
+      uint64_t w = 1;
+      for (size_t k = 0; k < length / 2; ++k) {
+        const uint64_t even = a[start + k];
+        const uint64_t odd = mul_mod(a[start + k + length / 2], w, p);
+        a[start + k] = add_mod(even, odd, p);
+        a[start + k + length / 2] = sub_mod(even, odd, p);
+        w = mul_mod(w, step, p);
+      }
+    }
+  }
+  if (inverse) {
+    const uint64_t scale = inv_mod(n % p, p);
+    for (uint64_t& value : a) {
+      value = mul_mod(value, scale, p);
+    }
+  }
+}
+
+// Integer matrix kept as decimal digit strings, so worker threads never
+// touch a bigfloat, plus a per-row bound on log2 of the Euclidean row norm.
+struct IntegerMatrix {
+  size_t rows{};
+  size_t cols{};
+  std::vector<std::string> digits;
+  std::vector<double> row_bits;
+};
+
+double decimal_bits(const std::string& digits) {
+  size_t length = digits.size() - (digits[0] == '-' ? 1 : 0);
+  if (length == 1 && digits.back() == '0') {
+    return 0.0;
+  }
+  return static_cast<double>(length) * std::log2(10.0);
+}
+
+// `extra` is appended as a last column when it is non-empty.
+std::optional<IntegerMatrix> to_integer_matrix(
+    const MatrixBF& matrix, const std::vector<bigfloat>& extra = {}) {
+  IntegerMatrix result;
+  result.rows = matrix.rows();
+  result.cols = matrix.cols() + (extra.empty() ? 0 : 1);
+  result.digits.reserve(result.rows * result.cols);
+  result.row_bits.assign(result.rows, 0.0);
+
+  for (size_t i = 0; i < result.rows; ++i) {
+    double max_bits = 0.0;
+    for (size_t j = 0; j < result.cols; ++j) {
+      const bigfloat& value = j < matrix.cols() ? matrix(i, j) : extra[i];
+      auto digits = integer_digits(value);
+      if (!digits) {
+        return std::nullopt;
+      }
+      max_bits = std::max(max_bits, decimal_bits(*digits));
+      result.digits.push_back(std::move(*digits));
+    }
+    result.row_bits[i] =
+        max_bits + 0.5 * std::log2(static_cast<double>(result.cols));
+  }
+  return result;
+}
+
+// Hadamard bound (in bits) on any minor built from `size` rows.
+double hadamard_bits(const IntegerMatrix& matrix, size_t size) {
+  std::vector<double> bits = matrix.row_bits;
+  std::sort(bits.begin(), bits.end(), std::greater<>());
+  double total = 0.0;
+  for (size_t i = 0; i < size && i < bits.size(); ++i) {
+    total += bits[i];
+  }
+  return total;
+}
+
+std::vector<uint64_t> reduce(const IntegerMatrix& matrix, uint64_t p) {
+  std::vector<uint64_t> result(matrix.digits.size());
+  for (size_t i = 0; i < result.size(); ++i) {
+    result[i] = decimal_residue(matrix.digits[i], p);
+  }
+  return result;
+}
+
+// Gauss-Jordan over Z/p on a row-major rows x cols buffer, pivoting in the
+// first `pivot_cols` columns. Returns the rank; `det` receives the product
+// of the pivots with the permutation sign (meaningful for square input).
+size_t eliminate_mod(std::vector<uint64_t>& a, size_t rows, size_t cols,
+                     size_t pivot_cols, uint64_t p, uint64_t& det) {
+  det = 1;
+  size_t row = 0;
+  for (size_t col = 0; col < pivot_cols && row < rows; ++col) {
+    size_t sel = row;
+    while (sel < rows && a[sel * cols + col] == 0) {
+      ++sel;
+    }
+    if (sel == rows) {
+      det = 0;
+      continue;
+    }
+    if (sel != row) {
+      std::swap_ranges(a.begin() + sel * cols, a.begin() + (sel + 1) * cols,
+                       a.begin() + row * cols);
+      det = det == 0 ? 0 : p - det;
+    }
+
+    uint64_t* pivot_row = a.data() + row * cols;
+    det = mul_mod(det, pivot_row[col], p);
+    const uint64_t inv = inv_mod(pivot_row[col], p);
+    for (size_t j = col; j < cols; ++j) {
+      pivot_row[j] = mul_mod(pivot_row[j], inv, p);
+    }
+
+    for (size_t i = 0; i < rows; ++i) {
+      uint64_t* current = a.data() + i * cols;
+      if (i == row || current[col] == 0) {
+        continue;
+      }
+      const uint64_t factor = current[col];
+      for (size_t j = col; j < cols; ++j) {
+        current[j] = sub_mod(current[j], mul_mod(factor, pivot_row[j], p), p);
+      }
+    }
+    ++row;
+  }
+  return row;
+}
+
+// Garner's mixed-radix form x = v0 + v1 p0 + v2 p0 p1 + ... for a fixed
+// list of primes. Everything that depends only on the primes is computed
+// once, so reconstructing many values costs O(k^2) uint64 steps and k
+// bigfloat products each.
+struct CrtBasis {
+  std::vector<uint64_t> primes;
+  // radix_mod[i][j] = p_0 ... p_{j-1} mod p_i, for j < i.
+  std::vector<std::vector<uint64_t>> radix_mod;
+  // (p_0 ... p_{i-1})^-1 mod p_i.
+  std::vector<uint64_t> inverse;
+  // p_0 ... p_{i-1}, then the full product.
+  std::vector<bigfloat> radix;
+};
+
+CrtBasis crt_basis(const std::vector<uint64_t>& primes) {
+  const size_t k = primes.size();
+  CrtBasis basis{primes, std::vector<std::vector<uint64_t>>(k),
+                 std::vector<uint64_t>(k), std::vector<bigfloat>(k + 1)};
+  for (size_t i = 0; i < k; ++i) {
+    const uint64_t p = primes[i];
+    uint64_t radix = 1;
+    for (size_t j = 0; j < i; ++j) {
+      basis.radix_mod[i].push_back(radix);
+      radix = mul_mod(radix, primes[j] % p, p);
+    }
+    basis.inverse[i] = inv_mod(radix, p);
+  }
+  basis.radix[0] = 1;
+  for (size_t i = 0; i < k; ++i) {
+    basis.radix[i + 1] =
+        basis.radix[i] * bigfloat(static_cast<unsigned long>(primes[i]));
+  }
+  return basis;
+}
+
+// The unique x with |x| < (p_0 * ... * p_k) / 2 and x = residues[i]
+// (mod p_i); every v_i is found in uint64 arithmetic and only the final sum
+// is bigfloat.
+bigfloat reconstruct(const std::vector<uint64_t>& residues,
+                     const CrtBasis& basis) {
+  const size_t k = basis.primes.size();
+  std::vector<uint64_t> mixed(k);
+  for (size_t i = 0; i < k; ++i) {
+    const uint64_t p = basis.primes[i];
+    uint64_t value = 0;
+    for (size_t j = 0; j < i; ++j) {
+      value = add_mod(value, mul_mod(mixed[j] % p, basis.radix_mod[i][j], p),
+                      p);
+    }
+    mixed[i] = mul_mod(sub_mod(residues[i] % p, value, p), basis.inverse[i], p);
+  }
+
+  bigfloat result = 0;
+  for (size_t i = 0; i < k; ++i) {
+    if (mixed[i] != 0) {
+      result += basis.radix[i] * bigfloat(static_cast<unsigned long>(mixed[i]));
+    }
+  }
+  if (result * bigfloat(2) > basis.radix[k]) {
+    result -= basis.radix[k];
+  }
+  return result;
+}
+
+}  // namespace
+
+std::vector<uint64_t> modular_primes(size_t count) {
+  static std::mutex mutex;
+  static std::vector<uint64_t> cache;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  uint64_t candidate = cache.empty() ? (uint64_t{1} << 62) - 1 : cache.back() - 2;
+  while (cache.size() < count) {
+    if (is_prime(candidate)) {
+      cache.push_back(candidate);
+    }
+    candidate -= 2;
+  }
+  return {cache.begin(), cache.begin() + count};
+}
+
+uint64_t decimal_residue(const std::string& digits, uint64_t prime) {
+  size_t begin = !digits.empty() && digits[0] == '-' ? 1 : 0;
+  uint64_t result = 0;
+  // Eighteen digits at a time still fit into a uint64 chunk.
+  for (size_t i = begin; i < digits.size(); i += 18) {
+    const size_t length = std::min<size_t>(18, digits.size() - i);
+    uint64_t chunk = 0;
+    uint64_t scale = 1;
+    for (size_t j = i; j < i + length; ++j) {
+      chunk = chunk * 10 + static_cast<uint64_t>(digits[j] - '0');
+      scale *= 10;
+    }
+    result = add_mod(mul_mod(result, scale % prime, prime), chunk % prime, prime);
+  }
+  return begin == 1 && result != 0 ? prime - result : result;
+}
+
+bigfloat crt_reconstruct(const std::vector<uint64_t>& residues,
+                         const std::vector<uint64_t>& primes) {
+  return reconstruct(residues, crt_basis(primes));
+}
+
+std::optional<bigfloat> modular_determinant(const MatrixBF& matrix) {
+  auto integer = to_integer_matrix(matrix);
+  if (!integer) {
+    return std::nullopt;
+  }
+  const size_t n = integer->rows;
+  const std::vector<uint64_t> primes =
+      modular_primes(primes_for_bits(hadamard_bits(*integer, n)));
+
+  std::vector<uint64_t> residues(primes.size());
+  parallel_for(0, primes.size(), [&](size_t i) {
+    std::vector<uint64_t> a = reduce(*integer, primes[i]);
+    eliminate_mod(a, n, n, n, primes[i], residues[i]);
+  });
+
+  return crt_reconstruct(residues, primes);
+}
+
+std::optional<size_t> modular_rank(const MatrixBF& matrix) {
+  auto integer = to_integer_matrix(matrix);
+  if (!integer) {
+    return std::nullopt;
+  }
+  // The true rank r has a nonzero r x r minor bounded by the Hadamard bound;
+  // one prime more than that bound can absorb cannot all divide it, so the
+  // largest rank seen modulo these primes is exact.
+  const size_t minor = std::min(integer->rows, integer->cols);
+  const double bits = hadamard_bits(*integer, minor);
+  const std::vector<uint64_t> primes = modular_primes(
+      static_cast<size_t>(std::floor(bits / kBitsPerPrime)) + 1);
+
+  std::vector<size_t> ranks(primes.size());
+  parallel_for(0, primes.size(), [&](size_t i) {
+    std::vector<uint64_t> a = reduce(*integer, primes[i]);
+    uint64_t det = 0;
+    ranks[i] = eliminate_mod(a, integer->rows, integer->cols, integer->cols,
+                             primes[i], det);
+  });
+
+  return *std::max_element(ranks.begin(), ranks.end());
+}
+
+std::optional<std::vector<bigfloat>> modular_solve(
+    const MatrixBF& matrix, const std::vector<bigfloat>& b) {
+  auto integer = to_integer_matrix(matrix, b);
+  if (!integer) {
+    return std::nullopt;
+  }
+  const size_t n = integer->rows;
+  const size_t cols = integer->cols;
+
+  // By Cramer's rule D * x_i = det(A_i) is an integer, where D = det(A) and
+  // A_i has column i replaced by b. Both are bounded by the Hadamard bound
+  // of [A | b], so that many primes with D != 0 (mod p) pin down D and every
+  // D * x_i, and x_i follows from one exact division.
+  const size_t needed = primes_for_bits(hadamard_bits(*integer, n));
+
+  std::vector<uint64_t> good_primes;
+  std::vector<uint64_t> det_residues;
+  std::vector<std::vector<uint64_t>> scaled_residues(n);
+  size_t used = 0;
+  size_t unlucky = 0;
+
+  while (good_primes.size() < needed) {
+    // A nonzero D is divisible by fewer than `needed` of these primes.
+    if (unlucky >= needed) {
+      throw std::runtime_error("No unique solution");
+    }
+    const size_t batch = needed - good_primes.size();
+    const std::vector<uint64_t> primes = modular_primes(used + batch);
+
+    std::vector<uint64_t> dets(batch);
+    std::vector<std::vector<uint64_t>> scaled(batch);
+    parallel_for(0, batch, [&](size_t t) {
+      const uint64_t p = primes[used + t];
+      std::vector<uint64_t> a = reduce(*integer, p);
+      eliminate_mod(a, n, cols, n, p, dets[t]);
+      if (dets[t] == 0) {
+        return;
+      }
+      scaled[t].resize(n);
+      for (size_t i = 0; i < n; ++i) {
+        scaled[t][i] = mul_mod(dets[t], a[i * cols + n], p);
+      }
+    });
+
+    for (size_t t = 0; t < batch; ++t) {
+      if (dets[t] == 0) {
+        ++unlucky;
+        continue;
+      }
+      good_primes.push_back(primes[used + t]);
+      det_residues.push_back(dets[t]);
+      for (size_t i = 0; i < n; ++i) {
+        scaled_residues[i].push_back(scaled[t][i]);
+      }
+    }
+    used += batch;
+  }
+
+  const bigfloat det = crt_reconstruct(det_residues, good_primes);
+  std::vector<bigfloat> result(n);
+  for (size_t i = 0; i < n; ++i) {
+    result[i] = crt_reconstruct(scaled_residues[i], good_primes) / det;
+  }
+  return result;
+}
+
+std::optional<MatrixBF> modular_multiply(const MatrixBF& lhs,
+                                         const MatrixBF& rhs) {
+  auto a = to_integer_matrix(lhs);
+  if (!a) {
+    return std::nullopt;
+  }
+  // Columns of rhs as rows, so that row_bits bounds their norms too.
+  auto b = to_integer_matrix(rhs.transpose());
+  if (!b) {
+    return std::nullopt;
+  }
+  const size_t m = a->rows;
+  const size_t inner = a->cols;
+  const size_t n = b->rows;
+  MatrixBF result(m, n);
+  if (m == 0 || inner == 0 || n == 0) {
+    return result;
+  }
+
+  // |c_ij| <= |row i of lhs| * |column j of rhs| by Cauchy-Schwarz.
+  const double bits =
+      *std::max_element(a->row_bits.begin(), a->row_bits.end()) +
+      *std::max_element(b->row_bits.begin(), b->row_bits.end());
+  const std::vector<uint64_t> primes = modular_primes(primes_for_bits(bits));
+  const size_t k = primes.size();
+
+  std::vector<std::vector<uint64_t>> a_mod(k);
+  std::vector<std::vector<uint64_t>> b_mod(k);
+  parallel_for(0, k, [&](size_t t) {
+    a_mod[t] = reduce(*a, primes[t]);
+    b_mod[t] = reduce(*b, primes[t]);
+  });
+
+  // Residues are below 2^62, so sixteen products fit into 128 bits before
+  // the sum has to be reduced.
+  constexpr size_t kLazyReductions = 16;
+  std::vector<std::vector<uint64_t>> c_mod(k, std::vector<uint64_t>(m * n));
+  parallel_for(0, k * m, [&](size_t task) {
+    const size_t t = task / m;
+    const size_t i = task % m;
+    const uint64_t p = primes[t];
+    const uint64_t* row = a_mod[t].data() + i * inner;
+    for (size_t j = 0; j < n; ++j) {
+      const uint64_t* col = b_mod[t].data() + j * inner;
+      unsigned __int128 sum = 0;
+      for (size_t l = 0; l < inner; ++l) {
+        sum += static_cast<unsigned __int128>(row[l]) * col[l];
+        if (l % kLazyReductions == kLazyReductions - 1) {
+          sum %= p;
+        }
+      }
+      c_mod[t][i * n + j] = static_cast<uint64_t>(sum % p);
+    }
+  });
+
+  const CrtBasis basis = crt_basis(primes);
+  std::vector<uint64_t> residues(k);
+  for (size_t i = 0; i < m; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      for (size_t t = 0; t < k; ++t) {
+        residues[t] = c_mod[t][i * n + j];
+      }
+      result(i, j) = reconstruct(residues, basis);
+    }
+  }
+  return result;
+}
+
+std::optional<std::vector<bigfloat>> modular_convolution(
+    const std::vector<bigfloat>& a, const std::vector<bigfloat>& b) {
+  if (a.empty() || b.empty()) {
+    return std::vector<bigfloat>{};
+  }
+  // Decimal digits for both operands, and the largest bit length of each.
+  std::vector<std::string> digits;
+  digits.reserve(a.size() + b.size());
+  double a_bits = 0.0;
+  double b_bits = 0.0;
+  for (size_t i = 0; i < a.size() + b.size(); ++i) {
+    auto value = integer_digits(i < a.size() ? a[i] : b[i - a.size()]);
+    if (!value) {
+      return std::nullopt;
+    }
+    double& bits = i < a.size() ? a_bits : b_bits;
+    bits = std::max(bits, decimal_bits(*value));
+    digits.push_back(std::move(*value));
+  }
+
+  const size_t length = a.size() + b.size() - 1;
+  const size_t n = std::bit_ceil(length);
+  if (n > (size_t{1} << kNttOrderBits)) {
+    throw std::length_error("modular_convolution: operands too long");
+  }
+  const double bits =
+      a_bits + b_bits +
+      std::log2(static_cast<double>(std::min(a.size(), b.size())));
+  const auto primes = ntt_primes(primes_for_bits(bits));
+
+  std::vector<std::vector<uint64_t>> residues(primes.size());
+  parallel_for(0, primes.size(), [&](size_t t) {
+    const auto [p, root] = primes[t];
+    std::vector<uint64_t> fa(n, 0);
+    std::vector<uint64_t> fb(n, 0);
+    for (size_t i = 0; i < a.size(); ++i) {
+      fa[i] = decimal_residue(digits[i], p);
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      fb[i] = decimal_residue(digits[a.size() + i], p);
+    }
+    ntt(fa, p, root, false);
+    ntt(fb, p, root, false);
+    for (size_t i = 0; i < n; ++i) {
+      fa[i] = mul_mod(fa[i], fb[i], p);
+    }
+    ntt(fa, p, root, true);
+    fa.resize(length);
+    residues[t] = std::move(fa);
+  });
+
+  std::vector<uint64_t> moduli(primes.size());
+  for (size_t t = 0; t < primes.size(); ++t) {
+    moduli[t] = primes[t].first;
+  }
+  std::vector<bigfloat> result(length);
+  std::vector<uint64_t> coefficient(primes.size());
+  for (size_t i = 0; i < length; ++i) {
+    for (size_t t = 0; t < primes.size(); ++t) {
+      coefficient[t] = residues[t][i];
+    }
+    result[i] = crt_reconstruct(coefficient, moduli);
+  }
+  return result;
+}
@@ -0,0 +1,344 @@
+#include "point_batch.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LINAL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+bool use_avx2() {
+#ifdef LINAL_SIMD_X86
+  static const bool supported = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  }();
+  return supported;
+#else
+  return false;
+#endif
+}
+
+void check_dimension(const PointBatch& points, size_t dimension,
+                     const std::string& op) {
+  if (points.dimension() != dimension) {
+    throw std::invalid_argument(
+        "PointBatch::" + op + " - dimension mismatch: " +
+        std::to_string(points.dimension()) + " != " +
+        std::to_string(dimension));
+  }
+}
+
+// What every kernel needs about the segment [a, b], computed once per call.
+struct Segment {
+  std::vector<double> a;
+  std::vector<double> ab;
+  double ab2 = 0.0;
+
+  Segment(const BasicVector<double>& start, const BasicVector<double>& end)
+      : a(start.components()), ab(end.components()) {
+    for (size_t k = 0; k < ab.size(); ++k) {
+      ab[k] -= a[k];
+      ab2 += ab[k] * ab[k];
+    }
+  }
+};
+
+// The portable kernels take a range of points so the vector kernels can
+// hand them the tail.
+
+void distance_scalar(const PointBatch& points, const Segment& s, size_t begin,
+                     size_t end, double* out) {
+  const size_t d = points.dimension();
+  for (size_t i = begin; i < end; ++i) {
+    double dot = 0.0;
+    for (size_t k = 0; k < d; ++k) {
+      dot += (points.coordinate(k)[i] - s.a[k]) * s.ab[k];
+    }
+    double t = s.ab2 == 0.0 ? 0.0 : dot / s.ab2;
+    t = std::fmin(std::fmax(t, 0.0), 1.0);
+    double dist2 = 0.0;
+    for (size_t k = 0; k < d; ++k) {
+      const double diff = points.coordinate(k)[i] - (s.a[k] + s.ab[k] * t);
+      dist2 += diff * diff;
+    }
+    out[i] = std::sqrt(dist2);
+  }
+}
+
+void on_segment_scalar(const PointBatch& points, const Segment& s, double eps,
+                       size_t begin, size_t end, bool* out) {
+  const size_t d = points.dimension();
+  for (size_t i = begin; i < end; ++i) {
+    bool on = true;
+    for (size_t p = 0; p < d && on; ++p) {
+      const double ap_p = points.coordinate(p)[i] - s.a[p];
+      for (size_t q = p + 1; q < d && on; ++q) {
+        const double ap_q = points.coordinate(q)[i] - s.a[q];
+        on = std::fabs(ap_p * s.ab[q] - ap_q * s.ab[p]) <= eps;
+      }
+    }
+    if (on) {
+      double dot = 0.0;
+      bool at_a = true;
+      for (size_t k = 0; k < d; ++k) {
+        const double ap = points.coordinate(k)[i] - s.a[k];
+        dot += ap * s.ab[k];
+        at_a = at_a && ap == 0.0;
+      }
+      if (s.ab2 == 0.0) {
+        on = at_a;
+      } else {
+        const double t = dot / s.ab2;
+        on = t >= -eps && t <= 1.0 + eps;
+      }
+    }
+    out[i] = on;
+  }
+}
+
+// Cosines only; acos runs per point afterwards for every implementation.
+void cosine_scalar(const PointBatch& points, const std::vector<double>& u,
+                   double u_norm, double eps, size_t begin, size_t end,
+                   double* out) {
+  const size_t d = points.dimension();
+  for (size_t i = begin; i < end; ++i) {
+    double dot = 0.0;
+    double norm2 = 0.0;
+    for (size_t k = 0; k < d; ++k) {
+      const double x = points.coordinate(k)[i];
+      dot += x * u[k];
+      norm2 += x * x;
+    }
+    const double norms = std::sqrt(norm2) * u_norm;
+    out[i] = norm2 == 0.0 || norms < eps
+                 ? std::numeric_limits<double>::quiet_NaN()
+                 : dot / norms;
+  }
+}
+
+#ifdef LINAL_SIMD_X86
+
+__attribute__((target("avx2,fma"))) void distance_avx2(
+    const PointBatch& points, const Segment& s, double* out) {
+  const size_t d = points.dimension();
+  const size_t n = points.size();
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d one = _mm256_set1_pd(1.0);
+  const __m256d inv_ab2 = _mm256_set1_pd(s.ab2 == 0.0 ? 0.0 : 1.0 / s.ab2);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d dot = zero;
+    for (size_t k = 0; k < d; ++k) {
+      const __m256d ap = _mm256_sub_pd(_mm256_loadu_pd(points.coordinate(k) + i),
+                                       _mm256_set1_pd(s.a[k]));
+      dot = _mm256_fmadd_pd(ap, _mm256_set1_pd(s.ab[k]), dot);
+    }
+    const __m256d t =
+        _mm256_min_pd(_mm256_max_pd(_mm256_mul_pd(dot, inv_ab2), zero), one);
+    __m256d dist2 = zero;
+    for (size_t k = 0; k < d; ++k) {
+      const __m256d closest = _mm256_fmadd_pd(
+          _mm256_set1_pd(s.ab[k]), t, _mm256_set1_pd(s.a[k]));
+      const __m256d diff =
+          _mm256_sub_pd(_mm256_loadu_pd(points.coordinate(k) + i), closest);
+      dist2 = _mm256_fmadd_pd(diff, diff, dist2);
+    }
+    _mm256_storeu_pd(out + i, _mm256_sqrt_pd(dist2));
+  }
+  distance_scalar(points, s, i, n, out);
+}
+
+// The minors and the projection dot are formed without fused multiply-add,
+// as in the scalar predicate, so the answers match it bit for bit and
+// points exactly on the line still give exact zeros. That relies on
+// -ffp-contract=off for this file (see CMakeLists.txt); under the default
+// -ffp-contract=fast GCC fuses the mul/sub pairs below.
+__attribute__((target("avx2,fma"))) void on_segment_avx2(
+    const PointBatch& points, const Segment& s, double eps, bool* out) {
+  const size_t d = points.dimension();
+  const size_t n = points.size();
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  const __m256d eps_v = _mm256_set1_pd(eps);
+  const __m256d lo = _mm256_set1_pd(-eps);
+  const __m256d hi = _mm256_set1_pd(1.0 + eps);
+  const __m256d ab2 = _mm256_set1_pd(s.ab2);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d on = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (size_t p = 0; p < d; ++p) {
+      const __m256d ap_p = _mm256_sub_pd(
+          _mm256_loadu_pd(points.coordinate(p) + i), _mm256_set1_pd(s.a[p]));
+      for (size_t q = p + 1; q < d; ++q) {
+        const __m256d ap_q = _mm256_sub_pd(
+            _mm256_loadu_pd(points.coordinate(q) + i), _mm256_set1_pd(s.a[q]));
+        const __m256d minor =
+            _mm256_sub_pd(_mm256_mul_pd(ap_p, _mm256_set1_pd(s.ab[q])),
+                          _mm256_mul_pd(ap_q, _mm256_set1_pd(s.ab[p])));
+        on = _mm256_and_pd(on, _mm256_cmp_pd(_mm256_andnot_pd(sign, minor),
+                                             eps_v, _CMP_LE_OQ));
+      }
+    }
+
+    __m256d dot = _mm256_setzero_pd();
+    __m256d at_a = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    for (size_t k = 0; k < d; ++k) {
+      const __m256d ap = _mm256_sub_pd(_mm256_loadu_pd(points.coordinate(k) + i),
+                                       _mm256_set1_pd(s.a[k]));
+      dot = _mm256_add_pd(dot, _mm256_mul_pd(ap, _mm256_set1_pd(s.ab[k])));
+      at_a = _mm256_and_pd(
+          at_a, _mm256_cmp_pd(ap, _mm256_setzero_pd(), _CMP_EQ_OQ));
+    }
+    __m256d within;
+    if (s.ab2 == 0.0) {
+      within = at_a;
+    } else {
+      const __m256d t = _mm256_div_pd(dot, ab2);
+      within = _mm256_and_pd(_mm256_cmp_pd(t, lo, _CMP_GE_OQ),
+                             _mm256_cmp_pd(t, hi, _CMP_LE_OQ));
+    }
+
+    const int bits = _mm256_movemask_pd(_mm256_and_pd(on, within));
+    for (size_t lane = 0; lane < 4; ++lane) {
+      out[i + lane] = (bits >> lane) & 1;
+    }
+  }
+  on_segment_scalar(points, s, eps, i, n, out);
+}
+
+__attribute__((target("avx2,fma"))) void cosine_avx2(
+    const PointBatch& points, const std::vector<double>& u, double u_norm,
+    double eps, double* out) {
+  const size_t d = points.dimension();
+  const size_t n = points.size();
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+  const __m256d u_norm_v = _mm256_set1_pd(u_norm);
+  const __m256d eps_v = _mm256_set1_pd(eps);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d dot = zero;
+    __m256d norm2 = zero;
+    for (size_t k = 0; k < d; ++k) {
+      const __m256d x = _mm256_loadu_pd(points.coordinate(k) + i);
+      dot = _mm256_fmadd_pd(x, _mm256_set1_pd(u[k]), dot);
+      norm2 = _mm256_fmadd_pd(x, x, norm2);
+    }
+    const __m256d norms = _mm256_mul_pd(_mm256_sqrt_pd(norm2), u_norm_v);
+    const __m256d invalid =
+        _mm256_or_pd(_mm256_cmp_pd(norm2, zero, _CMP_EQ_OQ),
+                     _mm256_cmp_pd(norms, eps_v, _CMP_LT_OQ));
+    _mm256_storeu_pd(out + i,
+                     _mm256_blendv_pd(_mm256_div_pd(dot, norms), nan, invalid));
+  }
+  cosine_scalar(points, u, u_norm, eps, i, n, out);
+}
+
+#endif
+
+}  // namespace
+
+PointBatch::PointBatch(const std::vector<BasicVector<double>>& points)
+    : coordinates_(points.empty() ? 0 : points[0].dimension()) {
+  reserve(points.size());
+  for (const auto& point : points) {
+    push_back(point);
+  }
+}
+
+void PointBatch::reserve(size_t count) {
+  for (auto& axis : coordinates_) {
+    axis.reserve(count);
+  }
+}
+
+void PointBatch::push_back(const BasicVector<double>& point) {
+  check_dimension(*this, point.dimension(), "push_back");
+  for (size_t k = 0; k < coordinates_.size(); ++k) {
+    coordinates_[k].push_back(point(k));
+  }
+  ++size_;
+}
+
+void PointBatch::clear() noexcept {
+  for (auto& axis : coordinates_) {
+    axis.clear();
+  }
+  size_ = 0;
+}
+
+BasicVector<double> PointBatch::point(size_t index) const {
+  if (index >= size_) {
+    throw std::out_of_range("PointBatch index out of range");
+  }
+  std::vector<double> result(coordinates_.size());
+  for (size_t k = 0; k < coordinates_.size(); ++k) {
+    result[k] = coordinates_[k][index];
+  }
+  return BasicVector<double>(result);
+}
+
+void point_to_segment_distance(const PointBatch& points,
+                               const BasicVector<double>& a,
+                               const BasicVector<double>& b, double* out) {
+  check_dimension(points, a.dimension(), "point_to_segment_distance");
+  check_dimension(points, b.dimension(), "point_to_segment_distance");
+  const Segment segment(a, b);
+#ifdef LINAL_SIMD_X86
+  if (use_avx2()) {
+    return distance_avx2(points, segment, out);
+  }
+#endif
+  distance_scalar(points, segment, 0, points.size(), out);
+}
+
+void is_point_on_segment(const PointBatch& points,
+                         const BasicVector<double>& a,
+                         const BasicVector<double>& b, bool* out,
+                         double EPS) {
+  check_dimension(points, a.dimension(), "is_point_on_segment");
+  check_dimension(points, b.dimension(), "is_point_on_segment");
+  if (EPS == 0.0) {
+    for (size_t i = 0; i < points.size(); ++i) {
+      out[i] = is_point_on_segment(points.point(i), a, b, 0.0);
+    }
+    return;
+  }
+  const Segment segment(a, b);
+#ifdef LINAL_SIMD_X86
+  if (use_avx2()) {
+    return on_segment_avx2(points, segment, EPS, out);
+  }
+#endif
+  on_segment_scalar(points, segment, EPS, 0, points.size(), out);
+}
+
+void angle_between(const PointBatch& points,
+                   const BasicVector<double>& direction, double* out,
+                   double EPS) {
+  check_dimension(points, direction.dimension(), "angle_between");
+  if (direction.is_zero()) {
+    throw std::domain_error("Angle with zero vector is undefined");
+  }
+  const double u_norm = direction.norm();
+#ifdef LINAL_SIMD_X86
+  if (use_avx2()) {
+    cosine_avx2(points, direction.components(), u_norm, EPS, out);
+  } else
+#endif
+  {
+    cosine_scalar(points, direction.components(), u_norm, EPS, 0,
+                  points.size(), out);
+  }
+  for (size_t i = 0; i < points.size(); ++i) {
+    if (!std::isnan(out[i])) {
+      out[i] = std::acos(std::fmax(-1.0, std::fmin(1.0, out[i])));
+    }
+  }
+}
@@ -0,0 +1,131 @@
+#include "robust_predicates.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Unit roundoff, half the distance from 1 to the next double.
+constexpr double kUnit = std::numeric_limits<double>::epsilon() / 2.0;
+
+// A value stored as a sum of doubles that do not overlap, smallest first,
+// so the last component carries the sign.
+using Expansion = std::vector<double>;
+
+// x + y = a + b exactly, x = fl(a + b).
+void two_sum(double a, double b, double& x, double& y) {
+  x = a + b;
+  const double b_virtual = x - a;
+  const double a_virtual = x - b_virtual;
+  y = (a - a_virtual) + (b - b_virtual);
+}
+
+// x + y = a * b exactly, x = fl(a * b).
+void two_product(double a, double b, double& x, double& y) {
+  x = a * b;
+  y = std::fma(a, b, -x);
+}
+
+// e += b, Shewchuk's GROW-EXPANSION with zero components dropped.
+void grow(Expansion& e, double b) {
+  size_t kept = 0;
+  double q = b;
+  for (size_t i = 0; i < e.size(); ++i) {
+    double sum, error;
+    two_sum(q, e[i], sum, error);
+    q = sum;
+    if (error != 0.0) {
+      e[kept++] = error;
+    }
+  }
+  e.resize(kept);
+  if (q != 0.0 || e.empty()) {
+    e.push_back(q);
+  }
+}
+
+// The exact difference a - b as one or two components.
+size_t difference(double a, double b, double* out) {
+  two_sum(a, -b, out[1], out[0]);
+  if (out[0] == 0.0) {
+    out[0] = out[1];
+    return 1;
+  }
+  return 2;
+}
+
+// e += x * y for x, y given as component lists.
+void add_product(Expansion& e, const double* x, size_t x_count,
+                 const double* y, size_t y_count) {
+  for (size_t i = 0; i < x_count; ++i) {
+    for (size_t j = 0; j < y_count; ++j) {
+      double product, error;
+      two_product(x[i], y[j], product, error);
+      grow(e, error);
+      grow(e, product);
+    }
+  }
+}
+
+int sign(double value) { return value > 0.0 ? 1 : (value < 0.0 ? -1 : 0); }
+
+}  // namespace
+
+int orientation_sign(double ax, double ay, double bx, double by, double cx,
+                     double cy) {
+  // Shewchuk's ccwerrboundA.
+  constexpr double kBound = (3.0 + 16.0 * kUnit) * kUnit;
+  const double left = (ax - cx) * (by - cy);
+  const double right = (ay - cy) * (bx - cx);
+  const double det = left - right;
+  if (std::fabs(det) > kBound * (std::fabs(left) + std::fabs(right))) {
+    return sign(det);
+  }
+
+  double acx[2], bcy[2], acy[2], bcx[2];
+  const size_t acx_count = difference(ax, cx, acx);
+  const size_t bcy_count = difference(by, cy, bcy);
+  const size_t acy_count = difference(ay, cy, acy);
+  const size_t bcx_count = difference(cx, bx, bcx);
+  Expansion exact;
+  add_product(exact, acx, acx_count, bcy, bcy_count);
+  add_product(exact, acy, acy_count, bcx, bcx_count);
+  return sign(exact.back());
+}
+
+int difference_dot_sign(const double* p, const double* q, const double* r,
+                        const double* s, size_t count) {
+  // Each term carries three roundings and the running sum count - 1 more;
+  // doubling the first-order bound absorbs the higher-order terms and the
+  // rounding of the bound itself.
+  double sum = 0.0;
+  double magnitude = 0.0;
+  for (size_t i = 0; i < count; ++i) {
+    const double term = (q ? p[i] - q[i] : p[i]) * (s ? r[i] - s[i] : r[i]);
+    sum += term;
+    magnitude += std::fabs(term);
+  }
+  const double bound = 2.0 * static_cast<double>(count + 3) * kUnit;
+  if (std::fabs(sum) > bound * magnitude) {
+    return sign(sum);
+  }
+
+  Expansion exact;
+  for (size_t i = 0; i < count; ++i) {
+    double left[2], right[2];
+    size_t left_count = 1, right_count = 1;
+    if (q) {
+      left_count = difference(p[i], q[i], left);
+    } else {
+      left[0] = p[i];
+    }
+    if (s) {
+      right_count = difference(r[i], s[i], right);
+    } else {
+      right[0] = r[i];
+    }
+    add_product(exact, left, left_count, right, right_count);
+  }
+  return exact.empty() ? 0 : sign(exact.back());
+}
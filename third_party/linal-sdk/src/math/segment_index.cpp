@@ -0,0 +1,300 @@
+#include "segment_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+
+#include "parallel_for.h"
+
+namespace {
+
+// Segments per parallel_for task when preparing boxes.
+constexpr size_t kPrepareChunk = 1024;
+
+}  // namespace
+
+SegmentIndex::SegmentIndex(
+    const std::vector<std::pair<BasicVector<double>, BasicVector<double>>>&
+        segments)
+    : dimension_(segments.empty() ? 0 : segments[0].first.dimension()) {
+  const size_t n = segments.size();
+  const size_t d = dimension_;
+  starts_.reserve(n);
+  ends_.reserve(n);
+  for (const auto& [a, b] : segments) {
+    check_dimension(a.dimension(), "SegmentIndex");
+    check_dimension(b.dimension(), "SegmentIndex");
+    starts_.push_back(a);
+    ends_.push_back(b);
+  }
+  if (n == 0) {
+    return;
+  }
+
+  lower_.resize(n * d);
+  upper_.resize(n * d);
+  centroid_.resize(n * d);
+  length_.resize(n);
+  parallel_for(0, (n + kPrepareChunk - 1) / kPrepareChunk, [&](size_t chunk) {
+    const size_t last = std::min(n, (chunk + 1) * kPrepareChunk);
+    for (size_t i = chunk * kPrepareChunk; i < last; ++i) {
+      double length2 = 0.0;
+      for (size_t k = 0; k < d; ++k) {
+        const double a = starts_[i](k);
+        const double b = ends_[i](k);
+        lower_[i * d + k] = std::min(a, b);
+        upper_[i * d + k] = std::max(a, b);
+        centroid_[i * d + k] = (a + b) / 2.0;
+        length2 += (b - a) * (b - a);
+      }
+      length_[i] = std::sqrt(length2);
+    }
+  });
+
+  order_.resize(n);
+  std::iota(order_.begin(), order_.end(), 0);
+  nodes_.resize(node_count(n));
+  node_lower_.resize(nodes_.size() * d);
+  node_upper_.resize(nodes_.size() * d);
+
+  std::vector<BuildTask> deferred;
+  build(0, 0, n, 0, &deferred);
+  parallel_for(0, deferred.size(), [&](size_t task) {
+    const BuildTask& t = deferred[task];
+    build(t.node, t.begin, t.end, kParallelDepth, nullptr);
+  });
+}
+
+size_t SegmentIndex::node_count(size_t count) {
+  if (count <= kLeafSize) {
+    return 1;
+  }
+  return 1 + node_count(count / 2) + node_count(count - count / 2);
+}
+
+void SegmentIndex::check_dimension(size_t dimension,
+                                   const std::string& op) const {
+  if (dimension != dimension_) {
+    throw std::invalid_argument("SegmentIndex::" + op +
+                                " - dimension mismatch: " +
+                                std::to_string(dimension) +
+                                " != " + std::to_string(dimension_));
+  }
+}
+
+void SegmentIndex::build(size_t node, size_t begin, size_t end, size_t depth,
+                         std::vector<BuildTask>* deferred) {
+  if (deferred && depth == kParallelDepth) {
+    deferred->push_back({node, begin, end});
+    return;
+  }
+
+  const size_t d = dimension_;
+  double* lower = node_lower_.data() + node * d;
+  double* upper = node_upper_.data() + node * d;
+  std::vector<double> centroid_lower(d, std::numeric_limits<double>::max());
+  std::vector<double> centroid_upper(d, std::numeric_limits<double>::lowest());
+  std::fill(lower, lower + d, std::numeric_limits<double>::max());
+  std::fill(upper, upper + d, std::numeric_limits<double>::lowest());
+  Node& current = nodes_[node];
+  for (size_t i = begin; i < end; ++i) {
+    const size_t s = order_[i];
+    for (size_t k = 0; k < d; ++k) {
+      lower[k] = std::min(lower[k], lower_[s * d + k]);
+      upper[k] = std::max(upper[k], upper_[s * d + k]);
+      centroid_lower[k] = std::min(centroid_lower[k], centroid_[s * d + k]);
+      centroid_upper[k] = std::max(centroid_upper[k], centroid_[s * d + k]);
+    }
+    current.max_length = std::max(current.max_length, length_[s]);
+    if (length_[s] > 0.0) {
+      current.max_inverse_length =
+          std::max(current.max_inverse_length, 1.0 / length_[s]);
+    }
+  }
+
+  const size_t count = end - begin;
+  if (count <= kLeafSize) {
+    current.first = begin;
+    current.count = count;
+    return;
+  }
+
+  size_t axis = 0;
+  for (size_t k = 1; k < d; ++k) {
+    if (centroid_upper[k] - centroid_lower[k] >
+        centroid_upper[axis] - centroid_lower[axis]) {
+      axis = k;
+    }
+  }
+  const size_t middle = begin + count / 2;
+  std::nth_element(order_.begin() + begin, order_.begin() + middle,
+                   order_.begin() + end, [&](size_t x, size_t y) {
+                     return centroid_[x * d + axis] < centroid_[y * d + axis];
+                   });
+
+  current.right = node + 1 + node_count(count / 2);
+  build(node + 1, begin, middle, depth + 1, deferred);
+  build(current.right, middle, end, depth + 1, deferred);
+}
+
+double SegmentIndex::box_distance2(size_t node,
+                                   const BasicVector<double>& point) const {
+  const double* lower = node_lower_.data() + node * dimension_;
+  const double* upper = node_upper_.data() + node * dimension_;
+  double distance2 = 0.0;
+  for (size_t k = 0; k < dimension_; ++k) {
+    const double x = point(k);
+    const double gap =
+        x < lower[k] ? lower[k] - x : (x > upper[k] ? x - upper[k] : 0.0);
+    distance2 += gap * gap;
+  }
+  return distance2;
+}
+
+// Best-first: nodes come off a queue ordered by box distance, and the
+// search stops once the nearest box is farther than the k-th best segment.
+std::vector<size_t> SegmentIndex::nearest(const BasicVector<double>& point,
+                                          size_t k) const {
+  check_dimension(point.dimension(), "nearest");
+  if (k == 0 || nodes_.empty()) {
+    return {};
+  }
+  using Entry = std::pair<double, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> pending;
+  // Max-heap of the best (distance, segment) pairs found so far.
+  std::priority_queue<Entry> best;
+  pending.push({box_distance2(0, point), 0});
+
+  while (!pending.empty()) {
+    const auto [distance2, node] = pending.top();
+    pending.pop();
+    if (best.size() == k && distance2 > best.top().first * best.top().first) {
+      break;
+    }
+    const Node& current = nodes_[node];
+    if (current.count == 0) {
+      pending.push({box_distance2(node + 1, point), node + 1});
+      pending.push({box_distance2(current.right, point), current.right});
+      continue;
+    }
+    for (size_t i = current.first; i < current.first + current.count; ++i) {
+      const size_t s = order_[i];
+      const Entry candidate{
+          point_to_segment_distance(point, starts_[s], ends_[s]), s};
+      if (best.size() < k) {
+        best.push(candidate);
+      } else if (candidate < best.top()) {
+        best.pop();
+        best.push(candidate);
+      }
+    }
+  }
+
+  std::vector<size_t> result(best.size());
+  for (size_t i = result.size(); i-- > 0;) {
+    result[i] = best.top().second;
+    best.pop();
+  }
+  return result;
+}
+
+std::vector<size_t> SegmentIndex::within_radius(
+    const BasicVector<double>& point, double radius) const {
+  check_dimension(point.dimension(), "within_radius");
+  std::vector<size_t> result;
+  if (nodes_.empty() || radius < 0.0) {
+    return result;
+  }
+  std::vector<size_t> stack{0};
+  while (!stack.empty()) {
+    const size_t node = stack.back();
+    stack.pop_back();
+    if (box_distance2(node, point) > radius * radius) {
+      continue;
+    }
+    const Node& current = nodes_[node];
+    if (current.count == 0) {
+      stack.push_back(node + 1);
+      stack.push_back(current.right);
+      continue;
+    }
+    for (size_t i = current.first; i < current.first + current.count; ++i) {
+      const size_t s = order_[i];
+      if (point_to_segment_distance(point, starts_[s], ends_[s]) <= radius) {
+        result.push_back(s);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// is_point_on_segment bounds every 2x2 minor of [p - a, b - a] by EPS and
+// the projection parameter to [-EPS, 1 + EPS]. Such a point lies within
+//   sqrt(d (d - 1) / 2) EPS / |b - a| + EPS |b - a|
+// of the segment (and on it when a = b), so a node whose box is farther
+// than that bound, taken over its segments, holds no match. kSlack covers
+// rounding in the predicate's own minors.
+std::vector<size_t> SegmentIndex::containing(const BasicVector<double>& point,
+                                             double EPS) const {
+  constexpr double kSlack = 1.0 + 1e-6;
+  check_dimension(point.dimension(), "containing");
+  std::vector<size_t> result;
+  if (nodes_.empty()) {
+    return result;
+  }
+  const double pairs =
+      std::sqrt(static_cast<double>(dimension_ * (dimension_ - 1)) / 2.0);
+  std::vector<size_t> stack{0};
+  while (!stack.empty()) {
+    const size_t node = stack.back();
+    stack.pop_back();
+    const Node& current = nodes_[node];
+    const double margin = kSlack * EPS *
+                          (pairs * current.max_inverse_length +
+                           current.max_length);
+    if (box_distance2(node, point) > margin * margin) {
+      continue;
+    }
+    if (current.count == 0) {
+      stack.push_back(node + 1);
+      stack.push_back(current.right);
+      continue;
+    }
+    for (size_t i = current.first; i < current.first + current.count; ++i) {
+      const size_t s = order_[i];
+      if (is_point_on_segment(point, starts_[s], ends_[s], EPS)) {
+        result.push_back(s);
+      }
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+std::vector<std::vector<size_t>> SegmentIndex::nearest(
+    const std::vector<BasicVector<double>>& points, size_t k) const {
+  std::vector<std::vector<size_t>> result(points.size());
+  parallel_for(0, points.size(),
+               [&](size_t i) { result[i] = nearest(points[i], k); });
+  return result;
+}
+
+std::vector<std::vector<size_t>> SegmentIndex::within_radius(
+    const std::vector<BasicVector<double>>& points, double radius) const {
+  std::vector<std::vector<size_t>> result(points.size());
+  parallel_for(0, points.size(),
+               [&](size_t i) { result[i] = within_radius(points[i], radius); });
+  return result;
+}
+
+std::vector<std::vector<size_t>> SegmentIndex::containing(
+    const std::vector<BasicVector<double>>& points, double EPS) const {
+  std::vector<std::vector<size_t>> result(points.size());
+  parallel_for(0, points.size(),
+               [&](size_t i) { result[i] = containing(points[i], EPS); });
+  return result;
+}
@@ -0,0 +1,386 @@
+#include "simd_kernels.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "aligned_allocator.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define LINAL_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+using AlignedBuffer = std::vector<double, AlignedAllocator<double>>;
+
+enum class Isa { SCALAR, AVX2, AVX512 };
+
+Isa detect_isa() {
+#ifdef LINAL_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return Isa::AVX512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return Isa::AVX2;
+  }
+#endif
+  return Isa::SCALAR;
+}
+
+Isa active_isa() {
+  static const Isa isa = detect_isa();
+  return isa;
+}
+
+// GEMM follows the usual packed layout: a kDepthBlock x kColBlock panel of
+// b and a kRowBlock x kDepthBlock panel of a are copied into contiguous
+// slivers sized for the micro-kernel, which then streams both from cache
+// and keeps a kRows x kCols tile of c in registers. Both block sizes are
+// multiples of every kernel's tile.
+constexpr size_t kDepthBlock = 256;
+constexpr size_t kRowBlock = 96;
+constexpr size_t kColBlock = 512;
+
+// Slivers of MR rows: for every depth index, MR consecutive values of a,
+// zero padded past the last row.
+template <size_t MR>
+void pack_a(const double* a, size_t lda, size_t rows, size_t depth,
+            double* out) {
+  for (size_t s = 0; s < rows; s += MR) {
+    const size_t height = std::min(MR, rows - s);
+    for (size_t p = 0; p < depth; ++p) {
+      for (size_t r = 0; r < height; ++r) {
+        *out++ = a[(s + r) * lda + p];
+      }
+      for (size_t r = height; r < MR; ++r) {
+        *out++ = 0.0;
+      }
+    }
+  }
+}
+
+// Slivers of NR columns: for every depth index, NR consecutive values of b,
+// zero padded past the last column.
+template <size_t NR>
+void pack_b(const double* b, size_t ldb, size_t depth, size_t cols,
+            double* out) {
+  for (size_t s = 0; s < cols; s += NR) {
+    const size_t width = std::min(NR, cols - s);
+    for (size_t p = 0; p < depth; ++p) {
+      const double* row = b + p * ldb + s;
+      for (size_t j = 0; j < width; ++j) {
+        *out++ = row[j];
+      }
+      for (size_t j = width; j < NR; ++j) {
+        *out++ = 0.0;
+      }
+    }
+  }
+}
+
+// Adds the rows x cols corner of a kRows x kCols tile to c.
+template <size_t MR, size_t NR>
+void add_partial_tile(const double* tile, double* c, size_t ldc, size_t rows,
+                      size_t cols) {
+  for (size_t r = 0; r < rows; ++r) {
+    for (size_t j = 0; j < cols; ++j) {
+      c[r * ldc + j] += tile[r * NR + j];
+    }
+  }
+}
+
+struct ScalarKernel {
+  static constexpr size_t kRows = 4;
+  static constexpr size_t kCols = 4;
+
+  static void run(size_t depth, const double* a, const double* b, double* c,
+                  size_t ldc, size_t rows, size_t cols) {
+    double tile[kRows * kCols] = {};
+    for (size_t p = 0; p < depth; ++p, a += kRows, b += kCols) {
+      for (size_t r = 0; r < kRows; ++r) {
+        for (size_t j = 0; j < kCols; ++j) {
+          tile[r * kCols + j] += a[r] * b[j];
+        }
+      }
+    }
+    add_partial_tile<kRows, kCols>(tile, c, ldc, rows, cols);
+  }
+};
+
+#ifdef LINAL_SIMD_X86
+
+struct Avx2Kernel {
+  static constexpr size_t kRows = 4;
+  static constexpr size_t kCols = 8;
+
+  __attribute__((target("avx2,fma"))) static void run(
+      size_t depth, const double* a, const double* b, double* c, size_t ldc,
+      size_t rows, size_t cols) {
+    __m256d acc[kRows][2];
+    for (size_t r = 0; r < kRows; ++r) {
+      acc[r][0] = _mm256_setzero_pd();
+      acc[r][1] = _mm256_setzero_pd();
+    }
+    for (size_t p = 0; p < depth; ++p, a += kRows, b += kCols) {
+      const __m256d b0 = _mm256_load_pd(b);
+      const __m256d b1 = _mm256_load_pd(b + 4);
+      for (size_t r = 0; r < kRows; ++r) {
+        const __m256d ar = _mm256_broadcast_sd(a + r);
+        acc[r][0] = _mm256_fmadd_pd(ar, b0, acc[r][0]);
+        acc[r][1] = _mm256_fmadd_pd(ar, b1, acc[r][1]);
+      }
+    }
+
+    if (rows == kRows && cols == kCols) {
+      for (size_t r = 0; r < kRows; ++r) {
+        double* out = c + r * ldc;
+        _mm256_storeu_pd(out, _mm256_add_pd(_mm256_loadu_pd(out), acc[r][0]));
+        _mm256_storeu_pd(out + 4,
+                         _mm256_add_pd(_mm256_loadu_pd(out + 4), acc[r][1]));
+      }
+      return;
+    }
+    alignas(64) double tile[kRows * kCols];
+    for (size_t r = 0; r < kRows; ++r) {
+      _mm256_store_pd(tile + r * kCols, acc[r][0]);
+      _mm256_store_pd(tile + r * kCols + 4, acc[r][1]);
+    }
+    add_partial_tile<kRows, kCols>(tile, c, ldc, rows, cols);
+  }
+};
+
+struct Avx512Kernel {
+  static constexpr size_t kRows = 8;
+  static constexpr size_t kCols = 16;
+
+  __attribute__((target("avx512f"))) static void run(
+      size_t depth, const double* a, const double* b, double* c, size_t ldc,
+      size_t rows, size_t cols) {
+    __m512d acc[kRows][2];
+    for (size_t r = 0; r < kRows; ++r) {
+      acc[r][0] = _mm512_setzero_pd();
+      acc[r][1] = _mm512_setzero_pd();
+    }
+    for (size_t p = 0; p < depth; ++p, a += kRows, b += kCols) {
+      const __m512d b0 = _mm512_load_pd(b);
+      const __m512d b1 = _mm512_load_pd(b + 8);
+      for (size_t r = 0; r < kRows; ++r) {
+        const __m512d ar = _mm512_set1_pd(a[r]);
+        acc[r][0] = _mm512_fmadd_pd(ar, b0, acc[r][0]);
+        acc[r][1] = _mm512_fmadd_pd(ar, b1, acc[r][1]);
+      }
+    }
+
+    if (rows == kRows && cols == kCols) {
+      for (size_t r = 0; r < kRows; ++r) {
+        double* out = c + r * ldc;
+        _mm512_storeu_pd(out, _mm512_add_pd(_mm512_loadu_pd(out), acc[r][0]));
+        _mm512_storeu_pd(out + 8,
+                         _mm512_add_pd(_mm512_loadu_pd(out + 8), acc[r][1]));
+      }
+      return;
+    }
+    alignas(64) double tile[kRows * kCols];
+    for (size_t r = 0; r < kRows; ++r) {
+      _mm512_store_pd(tile + r * kCols, acc[r][0]);
+      _mm512_store_pd(tile + r * kCols + 8, acc[r][1]);
+    }
+    add_partial_tile<kRows, kCols>(tile, c, ldc, rows, cols);
+  }
+};
+
+#endif
+
+template <typename Kernel>
+void gemm_packed(const double* a, const double* b, double* c, size_t m,
+                 size_t k, size_t n) {
+  constexpr size_t MR = Kernel::kRows;
+  constexpr size_t NR = Kernel::kCols;
+  static_assert(kRowBlock % MR == 0 && kColBlock % NR == 0);
+
+  std::fill(c, c + m * n, 0.0);
+  AlignedBuffer a_pack(kRowBlock * kDepthBlock);
+  AlignedBuffer b_pack(kColBlock * kDepthBlock);
+
+  for (size_t jc = 0; jc < n; jc += kColBlock) {
+    const size_t nc = std::min(kColBlock, n - jc);
+    for (size_t pc = 0; pc < k; pc += kDepthBlock) {
+      const size_t kc = std::min(kDepthBlock, k - pc);
+      pack_b<NR>(b + pc * n + jc, n, kc, nc, b_pack.data());
+
+      for (size_t ic = 0; ic < m; ic += kRowBlock) {
+        const size_t mc = std::min(kRowBlock, m - ic);
+        pack_a<MR>(a + ic * k + pc, k, mc, kc, a_pack.data());
+
+        for (size_t jr = 0; jr < nc; jr += NR) {
+          for (size_t ir = 0; ir < mc; ir += MR) {
+            Kernel::run(kc, a_pack.data() + ir * kc, b_pack.data() + jr * kc,
+                        c + (ic + ir) * n + jc + jr, n, std::min(MR, mc - ir),
+                        std::min(NR, nc - jr));
+          }
+        }
+      }
+    }
+  }
+}
+
+void axpy_scalar(double* y, const double* x, double alpha, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    y[i] += alpha * x[i];
+  }
+}
+
+// Square blocks of kTransposeBlock keep both the rows read and the rows
+// written resident in L1.
+constexpr size_t kTransposeBlock = 32;
+
+void transpose_scalar(const double* source, double* destination, size_t rows,
+                      size_t cols) {
+  for (size_t ib = 0; ib < rows; ib += kTransposeBlock) {
+    const size_t i_end = std::min(ib + kTransposeBlock, rows);
+    for (size_t jb = 0; jb < cols; jb += kTransposeBlock) {
+      const size_t j_end = std::min(jb + kTransposeBlock, cols);
+      for (size_t i = ib; i < i_end; ++i) {
+        for (size_t j = jb; j < j_end; ++j) {
+          destination[j * rows + i] = source[i * cols + j];
+        }
+      }
+    }
+  }
+}
+
+#ifdef LINAL_SIMD_X86
+
+__attribute__((target("avx2,fma"))) void axpy_avx2(double* y,
+                                                   const double* x,
+                                                   double alpha,
+                                                   size_t count) {
+  const __m256d scale = _mm256_set1_pd(alpha);
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(scale, _mm256_loadu_pd(x + i),
+                                            _mm256_loadu_pd(y + i)));
+  }
+  for (; i < count; ++i) {
+    y[i] += alpha * x[i];
+  }
+}
+
+__attribute__((target("avx512f"))) void axpy_avx512(double* y,
+                                                    const double* x,
+                                                    double alpha,
+                                                    size_t count) {
+  const __m512d scale = _mm512_set1_pd(alpha);
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(scale, _mm512_loadu_pd(x + i),
+                                            _mm512_loadu_pd(y + i)));
+  }
+  if (i < count) {
+    const __mmask8 tail = static_cast<__mmask8>((1u << (count - i)) - 1);
+    _mm512_mask_storeu_pd(
+        y + i, tail,
+        _mm512_fmadd_pd(scale, _mm512_maskz_loadu_pd(tail, x + i),
+                        _mm512_maskz_loadu_pd(tail, y + i)));
+  }
+}
+
+// 4 x 4 tiles are transposed in registers; the ragged edges of each block
+// fall back to single elements.
+__attribute__((target("avx2"))) void transpose_avx2(
+    const double* source, double* destination, size_t rows, size_t cols) {
+  for (size_t ib = 0; ib < rows; ib += kTransposeBlock) {
+    const size_t i_end = std::min(ib + kTransposeBlock, rows);
+    for (size_t jb = 0; jb < cols; jb += kTransposeBlock) {
+      const size_t j_end = std::min(jb + kTransposeBlock, cols);
+      size_t i = ib;
+      for (; i + 4 <= i_end; i += 4) {
+        size_t j = jb;
+        for (; j + 4 <= j_end; j += 4) {
+          const double* s = source + i * cols + j;
+          const __m256d r0 = _mm256_loadu_pd(s);
+          const __m256d r1 = _mm256_loadu_pd(s + cols);
+          const __m256d r2 = _mm256_loadu_pd(s + 2 * cols);
+          const __m256d r3 = _mm256_loadu_pd(s + 3 * cols);
+          const __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+          const __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+          const __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+          const __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+          double* d = destination + j * rows + i;
+          _mm256_storeu_pd(d, _mm256_permute2f128_pd(t0, t2, 0x20));
+          _mm256_storeu_pd(d + rows, _mm256_permute2f128_pd(t1, t3, 0x20));
+          _mm256_storeu_pd(d + 2 * rows, _mm256_permute2f128_pd(t0, t2, 0x31));
+          _mm256_storeu_pd(d + 3 * rows, _mm256_permute2f128_pd(t1, t3, 0x31));
+        }
+        for (size_t r = i; r < i + 4; ++r) {
+          for (size_t jj = j; jj < j_end; ++jj) {
+            destination[jj * rows + r] = source[r * cols + jj];
+          }
+        }
+      }
+      for (; i < i_end; ++i) {
+        for (size_t j = jb; j < j_end; ++j) {
+          destination[j * rows + i] = source[i * cols + j];
+        }
+      }
+    }
+  }
+}
+
+#endif
+
+}  // namespace
+
+const char* simd_isa() {
+  switch (active_isa()) {
+    case Isa::AVX512:
+      return "avx512";
+    case Isa::AVX2:
+      return "avx2";
+    case Isa::SCALAR:
+      break;
+  }
+  return "scalar";
+}
+
+void simd_gemm(const double* a, const double* b, double* c, size_t m,
+               size_t k, size_t n) {
+  switch (active_isa()) {
+#ifdef LINAL_SIMD_X86
+    case Isa::AVX512:
+      return gemm_packed<Avx512Kernel>(a, b, c, m, k, n);
+    case Isa::AVX2:
+      return gemm_packed<Avx2Kernel>(a, b, c, m, k, n);
+#endif
+    default:
+      return gemm_packed<ScalarKernel>(a, b, c, m, k, n);
+  }
+}
+
+void simd_axpy(double* y, const double* x, double alpha, size_t count) {
+  switch (active_isa()) {
+#ifdef LINAL_SIMD_X86
+    case Isa::AVX512:
+      return axpy_avx512(y, x, alpha, count);
+    case Isa::AVX2:
+      return axpy_avx2(y, x, alpha, count);
+#endif
+    default:
+      return axpy_scalar(y, x, alpha, count);
+  }
+}
+
+void simd_transpose(const double* source, double* destination, size_t rows,
+                    size_t cols) {
+  switch (active_isa()) {
+#ifdef LINAL_SIMD_X86
+    case Isa::AVX512:
+    case Isa::AVX2:
+      return transpose_avx2(source, destination, rows, cols);
+#endif
+    default:
+      return transpose_scalar(source, destination, rows, cols);
+  }
+}
@@ -0,0 +1,74 @@
+#include "sparse_ordering.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include <utility>
+
+std::vector<size_t> minimum_degree_ordering(
+    std::vector<std::vector<size_t>> adjacency) {
+  const size_t n = adjacency.size();
+
+  // Symmetrise, then sort and deduplicate every list.
+  for (size_t v = 0; v < n; ++v) {
+    for (size_t i = 0, count = adjacency[v].size(); i < count; ++i) {
+      const size_t u = adjacency[v][i];
+      if (u != v && u < n) {
+        adjacency[u].push_back(v);
+      }
+    }
+  }
+  for (size_t v = 0; v < n; ++v) {
+    auto& list = adjacency[v];
+    std::sort(list.begin(), list.end());
+    list.erase(std::unique(list.begin(), list.end()), list.end());
+    std::erase_if(list, [&](size_t u) { return u == v || u >= n; });
+  }
+
+  // Entries go stale when a degree changes; they are skipped on pop.
+  using Entry = std::pair<size_t, size_t>;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+  std::vector<size_t> degree(n);
+  for (size_t v = 0; v < n; ++v) {
+    degree[v] = adjacency[v].size();
+    queue.emplace(degree[v], v);
+  }
+
+  std::vector<char> eliminated(n, 0);
+  std::vector<size_t> order;
+  order.reserve(n);
+  std::vector<size_t> clique;
+  std::vector<size_t> merged;
+
+  while (!queue.empty()) {
+    const auto [d, v] = queue.top();
+    queue.pop();
+    if (eliminated[v] || d != degree[v]) {
+      continue;
+    }
+    eliminated[v] = 1;
+    order.push_back(v);
+
+    clique.clear();
+    for (size_t u : adjacency[v]) {
+      if (!eliminated[u]) {
+        clique.push_back(u);
+      }
+    }
+
+    for (size_t u : clique) {
+      merged.clear();
+      std::set_union(adjacency[u].begin(), adjacency[u].end(), clique.begin(),
+                     clique.end(), std::back_inserter(merged));
+      std::erase_if(merged, [&](size_t w) { return w == u || eliminated[w]; });
+      adjacency[u].swap(merged);
+      if (adjacency[u].size() != degree[u]) {
+        degree[u] = adjacency[u].size();
+        queue.emplace(degree[u], u);
+      }
+    }
+    std::vector<size_t>().swap(adjacency[v]);
+  }
+  return order;
+}